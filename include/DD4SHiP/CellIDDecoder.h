@@ -0,0 +1,195 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Dependency-free decoder for DD4hep <id> descriptors ("system:8,layer:6,...")
+// so that compiled analysis macros and tools can decode cellIDs without
+// loading the geometry. Field layout follows DD4hep's BitFieldCoder:
+// fields are packed from bit 0 in order, "name:offset:width" sets the
+// offset explicitly and a negative width marks a signed field.
+//
+// The descriptors are read from the <readouts> of a compact file and the
+// files it includes (compactReadouts), so they follow the geometry that
+// was simulated. Inside DD4hep, construct the decoder from
+// Readout::idSpec().fieldDescription() instead. The built-in table
+// knownReadouts() is only a fallback when no compact file is given, and
+// its use is reported on stderr.
+//
+//==========================================================================
+#ifndef DD4SHIP_CELLIDDECODER_H
+#define DD4SHIP_CELLIDDECODER_H
+
+#include <cstdint>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dd4ship {
+
+  /// Fallback copy of the readout descriptors of Detectors/PID/* (SHiP_HPL_Fibre_Tracker_test.xml
+  /// for the fibre tracker; BoxOfStraws_sensitive.xml uses the same readout name with straw:16)
+  inline const std::map<std::string, std::string>& knownReadouts()  {
+    static const std::map<std::string, std::string> ro = {
+      { "SplitCalWideBarHits", "system:8,splitcal_bar:6,splitcal_layer:6,x:22,y:22" },
+      { "SplitCalThinBarHits", "system:8,splitcal_bar:8,splitcal_layer:8,x:20,y:20" },
+      { "SplitCalHPLHits",     "system:8,splitcal_layer:4,splitcal_hpl_layer:4,splitcal_hplfibre:12,x:16,y:16" },
+      { "SHiPHCALHits",        "system:8,hcal_layer:4,widebar:10,hcal_passivelayer:1,x:16,y:16" },
+      { "SHiP_HPL_Fibre_TrackerHits", "system:8,layer:16,fibre:16,y:-12" }
+    };
+    return ro;
+  }
+
+  namespace detail  {
+    inline std::string attribute(const std::string& tag, const std::string& name)  {
+      for( const char q : { '"', '\'' } )  {
+        const std::string key = name + "=" + q;
+        std::size_t p = tag.find(key);
+        while( p != std::string::npos && p > 0 && !std::isspace((unsigned char)tag[p-1]) )
+          p = tag.find(key, p+1);
+        if ( p == std::string::npos ) continue;
+        p += key.size();
+        return tag.substr(p, tag.find(q, p) - p);
+      }
+      return "";
+    }
+    inline void scanCompact(const std::string& path, std::map<std::string, std::string>& ro, int depth)  {
+      if ( depth > 20 ) throw std::runtime_error("CellIDDecoder: include depth exceeded at "+path);
+      std::ifstream in(path);
+      if ( !in ) throw std::runtime_error("CellIDDecoder: cannot read compact file "+path);
+      std::stringstream buf;
+      buf << in.rdbuf();
+      std::string text = buf.str();
+      for( std::size_t c = text.find("<!--"); c != std::string::npos; c = text.find("<!--", c) )  {
+        std::size_t e = text.find("-->", c);
+        text.erase(c, e == std::string::npos ? std::string::npos : e + 3 - c);
+      }
+      const std::size_t slash = path.rfind('/');
+      const std::string dir = slash == std::string::npos ? "" : path.substr(0, slash+1);
+      for( std::size_t p = text.find('<'); p != std::string::npos; p = text.find('<', p+1) )  {
+        const std::size_t end = text.find('>', p);
+        if ( end == std::string::npos ) break;
+        const std::string tag = text.substr(p, end - p + 1);
+        if ( tag.compare(0, 9, "<include ") == 0 )  {
+          const std::string ref = attribute(tag, "ref");
+          if ( !ref.empty() ) scanCompact(ref[0] == '/' ? ref : dir + ref, ro, depth+1);
+        }
+        else if ( tag.compare(0, 9, "<readout ") == 0 )  {
+          const std::size_t close = text.find("</readout>", end);
+          const std::size_t id    = text.find("<id>", end);
+          if ( id == std::string::npos || id > close ) continue;
+          std::string desc;
+          for( std::size_t i = id + 4; i < text.size() && text[i] != '<'; ++i )
+            if ( !std::isspace((unsigned char)text[i]) ) desc += text[i];
+          ro[attribute(tag, "name")] = desc;
+        }
+      }
+    }
+  }
+
+  /// Readout descriptors of a compact file and of all files it includes, by readout name
+  inline std::map<std::string, std::string> compactReadouts(const std::string& compact)  {
+    std::map<std::string, std::string> ro;
+    detail::scanCompact(compact, ro, 0);
+    return ro;
+  }
+
+  struct CellIDField  {
+    std::string   name;
+    unsigned      offset = 0;
+    unsigned      width  = 0;
+    bool          isSigned = false;
+    std::uint64_t mask   = 0;
+
+    /// Field value of a cellID
+    inline long value(std::uint64_t cellID) const  {
+      std::uint64_t v = (cellID & mask) >> offset;
+      if ( isSigned && (v & (std::uint64_t(1) << (width-1))) )
+        return long(v) - (long(1) << width);
+      return long(v);
+    }
+  };
+
+  class CellIDDecoder  {
+    std::vector<CellIDField> m_fields;
+
+  public:
+    CellIDDecoder() = default;
+    explicit CellIDDecoder(const std::string& descriptor)  {
+      std::stringstream ss(descriptor);
+      std::string tok;
+      unsigned next = 0;
+      while( std::getline(ss, tok, ',') )  {
+        std::vector<std::string> p;
+        std::stringstream ts(tok);
+        std::string s;
+        while( std::getline(ts, s, ':') ) p.push_back(s);
+        if ( p.size() < 2 || p.size() > 3 )
+          throw std::runtime_error("CellIDDecoder: bad field '"+tok+"' in "+descriptor);
+        CellIDField f;
+        f.name = p[0];
+        int w  = std::atoi(p.back().c_str());
+        f.offset   = p.size() == 3 ? unsigned(std::atoi(p[1].c_str())) : next;
+        f.isSigned = w < 0;
+        f.width    = unsigned(w < 0 ? -w : w);
+        f.mask     = (f.width >= 64 ? ~std::uint64_t(0) : ((std::uint64_t(1) << f.width) - 1)) << f.offset;
+        next       = f.offset + f.width;
+        m_fields.push_back(f);
+      }
+    }
+    /// Decoder of a readout of the compact file; without compact file from knownReadouts()
+    static CellIDDecoder forReadout(const std::string& readout, const std::string& compact = "")  {
+      if ( !compact.empty() )  {
+        const auto ro = compactReadouts(compact);
+        auto it = ro.find(readout);
+        if ( it == ro.end() )
+          throw std::runtime_error("CellIDDecoder: no readout "+readout+" in "+compact);
+        return CellIDDecoder(it->second);
+      }
+      auto it = knownReadouts().find(readout);
+      if ( it == knownReadouts().end() )
+        throw std::runtime_error("CellIDDecoder: unknown readout "+readout+" (give the compact file)");
+      static std::mutex lock;
+      static std::set<std::string> warned;
+      std::lock_guard<std::mutex> guard(lock);
+      if ( warned.insert(readout).second )
+        std::cerr << "CellIDDecoder: WARNING no compact file given, using the built-in descriptor of "
+                  << readout << ": " << it->second << std::endl;
+      return CellIDDecoder(it->second);
+    }
+    /// True if forReadout(readout, compact) finds a descriptor
+    static bool hasReadout(const std::string& readout, const std::string& compact = "")  {
+      return compact.empty() ? knownReadouts().count(readout) > 0 : compactReadouts(compact).count(readout) > 0;
+    }
+
+    const std::vector<CellIDField>& fields() const { return m_fields; }
+    bool has(const std::string& name) const  {
+      for( const auto& f : m_fields ) if ( f.name == name ) return true;
+      return false;
+    }
+    const CellIDField& field(const std::string& name) const  {
+      for( const auto& f : m_fields ) if ( f.name == name ) return f;
+      throw std::runtime_error("CellIDDecoder: no field "+name);
+    }
+    long value(const std::string& name, std::uint64_t cellID) const  {
+      return field(name).value(cellID);
+    }
+  };
+}
+#endif // DD4SHIP_CELLIDDECODER_H
@@ -0,0 +1,122 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Bounded MC truth per calorimeter hit.
+//
+// Step contributions of the same MC particle within the same time bin are
+// merged into one entry: deposits are summed, the time is the earliest,
+// the position is deposit weighted. The track length is not merged: like
+// the momentum it stays that of the first step, so after merging 'length'
+// is not the length travelled in the cell.
+//
+// When a hit holds more than twice the cap, all but the 'maxContributions'
+// largest deposits are folded into a single remainder entry, and once more
+// at the end of the event, so a hit never stores more than
+// 2*maxContributions+1 entries. The remainder is flagged by a negative
+// length (REMAINDER_LENGTH), which no step has; PDG codes cannot flag it,
+// since geantinos and generator records have pdgID 0. It carries the
+// trackID and pdgID of the largest contribution folded when it was
+// created, a real track, so the MC truth mapping of the output actions
+// applies to it as to any other entry. Its momentum is that of that
+// contribution.
+//
+// Written for DDG4's Geant4HitData::MonteCarloContrib, but any type with
+// the members trackID, deposit, time, length, x, y, z works.
+//
+//==========================================================================
+#ifndef DD4SHIP_CONTRIBUTIONCOMPACTION_H
+#define DD4SHIP_CONTRIBUTIONCOMPACTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace dd4ship {
+
+  struct ContributionCompaction  {
+    int    maxContributions = 0;     // 0: keep every step contribution
+    double timeBin          = 1.;    // [ns], <= 0: one entry per particle
+
+    /// Track length flagging the remainder entry
+    static constexpr double REMAINDER_LENGTH = -1.;
+
+    template <typename CONTRIB> static bool isRemainder(const CONTRIB& c)  {
+      return c.length < 0;
+    }
+
+    bool enabled() const  { return maxContributions > 0; }
+
+    long bin(double time) const  {
+      return timeBin > 0 ? long(std::floor(time/timeBin)) : 0L;
+    }
+
+    /// Merge contribution c into m
+    template <typename CONTRIB> static void merge(CONTRIB& m, const CONTRIB& c)  {
+      const double e = m.deposit + c.deposit;
+      if ( e > 0 )  {
+        m.x = (m.x*m.deposit + c.x*c.deposit)/e;
+        m.y = (m.y*m.deposit + c.y*c.deposit)/e;
+        m.z = (m.z*m.deposit + c.z*c.deposit)/e;
+      }
+      m.deposit = e;
+      m.time    = std::min(m.time, c.time);
+    }
+
+    /// Add the contribution of one step to the list of a hit
+    template <typename CONTRIB> void add(std::vector<CONTRIB>& truth, const CONTRIB& c) const  {
+      if ( !enabled() )  {
+        truth.push_back(c);
+        return;
+      }
+      const long b = bin(c.time);
+      // the latest entries are the most likely match: search backwards
+      for( auto it = truth.rbegin(); it != truth.rend(); ++it )  {
+        if ( it->trackID == c.trackID && bin(it->time) == b && !isRemainder(*it) )  {
+          merge(*it, c);
+          return;
+        }
+      }
+      truth.push_back(c);
+      if ( truth.size() > std::size_t(2*maxContributions+1) ) compact(truth);
+    }
+
+    /// Keep the maxContributions largest deposits, fold the others into the remainder
+    template <typename CONTRIB> void compact(std::vector<CONTRIB>& truth) const  {
+      if ( !enabled() ) return;
+      auto rem = std::find_if(truth.begin(), truth.end(), [](const CONTRIB& c) { return isRemainder(c); });
+      if ( truth.size() - (rem != truth.end() ? 1 : 0) <= std::size_t(maxContributions) ) return;
+      CONTRIB remainder;
+      bool    hasRemainder = rem != truth.end();
+      if ( hasRemainder )  {
+        remainder = *rem;
+        truth.erase(rem);
+      }
+      auto nth = truth.begin() + maxContributions;
+      std::nth_element(truth.begin(), nth, truth.end(),
+                       [](const CONTRIB& a, const CONTRIB& b) { return a.deposit > b.deposit; });
+      if ( !hasRemainder )  {
+        // *nth is the largest folded contribution: its track ID is a real one
+        remainder        = *nth;
+        remainder.length = REMAINDER_LENGTH;
+        hasRemainder    = true;
+        ++nth;
+      }
+      for( auto it = nth; it != truth.end(); ++it ) merge(remainder, *it);
+      nth = truth.begin() + maxContributions;
+      truth.erase(nth, truth.end());
+      std::sort(truth.begin(), truth.end(), [](const CONTRIB& a, const CONTRIB& b) { return a.time < b.time; });
+      if ( hasRemainder ) truth.push_back(remainder);
+    }
+  };
+}
+#endif // DD4SHIP_CONTRIBUTIONCOMPACTION_H
@@ -0,0 +1,46 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Geant4 logical volume of a detector's placement, for the Geant4 actions
+// that treat whole detectors as envelopes (fast muons, MC truth reduction).
+//
+// The volume is taken from the DD4hep -> Geant4 volume map, not looked up
+// by name: logical volume names are not unique, the SplitCal builders reuse
+// the detector name for inner boxes.
+//
+//==========================================================================
+#ifndef DD4SHIP_ENVELOPEVOLUME_H
+#define DD4SHIP_ENVELOPEVOLUME_H
+
+#include <DD4hep/Detector.h>
+#include <DDG4/Geant4GeometryInfo.h>
+
+#include <string>
+
+class G4LogicalVolume;
+
+namespace dd4ship {
+
+  /// Logical volume of the placement of detector 'det', nullptr if unknown
+  inline G4LogicalVolume* envelopeVolume(dd4hep::Detector& description, const dd4hep::sim::Geant4GeometryInfo& geo,
+                                         const std::string& det)  {
+    const auto& dets = description.detectors();
+    auto d = dets.find(det);
+    if ( d == dets.end() ) return nullptr;
+    dd4hep::PlacedVolume pv = dd4hep::DetElement(d->second).placement();
+    if ( !pv.isValid() ) return nullptr;
+    auto lv = geo.g4Volumes.find(pv.volume().ptr());
+    return lv == geo.g4Volumes.end() ? nullptr : lv->second;
+  }
+}
+#endif // DD4SHIP_ENVELOPEVOLUME_H
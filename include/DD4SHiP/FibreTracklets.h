@@ -0,0 +1,339 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Fibre hit clustering and tracklet building for the HPL fibre layers
+// (SplitCal HPL modules and the SHiP_HPL_Fibre_Tracker).
+//
+// Fibre layers come in big/small pairs, the small layer shifted by half a
+// pitch. A fibre is mapped to a half-pitch index u = 2*i (big) or 2*i+1
+// (small), so that both sublayers of a plane form one staggered row; hits
+// are sorted by (plane, u) and runs of neighbouring u become clusters.
+//
+// Tracklets are built per view (planes measuring x or y), ordered in z:
+// seeds are cluster pairs in nearby planes within a slope cut, extended
+// plane by plane inside a window around the straight line prediction.
+// Branches are pruned as soon as chi2/ndf exceeds the cut, and the total
+// number of extensions per event is bounded so that busy showers cannot
+// blow up. Overlapping candidates are resolved greedily (most clusters,
+// then lowest chi2), clusters are not shared between tracklets.
+//
+//==========================================================================
+#ifndef DD4SHIP_FIBRETRACKLETS_H
+#define DD4SHIP_FIBRETRACKLETS_H
+
+#include <DD4SHiP/CellIDDecoder.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dd4ship {
+
+  enum FibreView  { VIEW_X = 0, VIEW_Y = 1 };
+
+  /// How the cellIDs of one readout map to planes and half-pitch positions
+  struct FibreLayout  {
+    std::string      moduleField;           // empty if there is one module only
+    std::string      sublayerField;
+    std::string      fibreField;
+    long             smallOffset = 0;       // index of the first small-sublayer fibre
+    int              sublayersPerPlane = 2; // big + small
+    std::vector<int> moduleViews;           // view per module value, empty: all VIEW_X
+
+    /// SHiP_HPL_Fibre_Tracker: fibres along y, numbered from 0 in every sublayer
+    static FibreLayout fibreTracker()  {
+      return { "", "layer", "fibre", 0, 2, {} };
+    }
+    /// SplitCal HPL modules: big and small fibres are numbered consecutively,
+    /// code 5 modules are rotated (measure y), code 6 measure x
+    static FibreLayout splitCalHPL(const std::string& layerCodes, long nBig = 1800)  {
+      FibreLayout l { "splitcal_layer", "splitcal_hpl_layer", "splitcal_hplfibre", nBig, 2, {} };
+      for( char c : layerCodes )  {
+        if ( c == '5' ) l.moduleViews.push_back(VIEW_Y);
+        else if ( c == '6' ) l.moduleViews.push_back(VIEW_X);
+      }
+      return l;
+    }
+  };
+
+  struct FibreTrackingConfig  {
+    float       minEnergy     = 0.f;   // hit threshold [MeV]
+    int         maxGap        = 0;     // missing half-pitch positions allowed inside a cluster
+    double      resolution    = 0.35;  // cluster position resolution [mm]
+    double      maxSlope      = 1.0;   // seed cut on |d pos/d z|
+    double      window        = 2.0;   // search window around the prediction [mm]
+    double      maxChi2       = 9.0;   // prune candidates above this chi2/ndf
+    int         minClusters   = 3;
+    int         maxMissed     = 1;     // consecutive planes without a cluster
+    std::size_t maxExtensions = 200000;// per event; seeding stops beyond this
+  };
+
+  struct FibreCluster  {
+    std::uint32_t plane  = 0;
+    float         pos    = 0;   // measured coordinate [mm]
+    float         z      = 0;
+    float         energy = 0;
+    std::uint32_t size   = 0;   // number of hits
+    std::int32_t  umin   = 0, umax = 0;
+  };
+
+  struct FibrePlane  {
+    std::uint64_t key   = 0;    // module << 16 | plane in module
+    int           view  = VIEW_X;
+    float         z     = 0;
+    std::uint32_t first = 0, last = 0;  // clusters [first, last), sorted by pos
+  };
+
+  struct FibreTracklet  {
+    int    view      = VIEW_X;
+    double z0        = 0;       // pos(z) = intercept + slope*(z - z0)
+    double intercept = 0;
+    double slope     = 0;
+    double chi2      = 0;
+    int    ndf       = 0;
+    std::vector<std::uint32_t> clusters;
+  };
+
+  class FibreTrackletFinder  {
+    struct Hit  {
+      std::uint64_t key;   // plane key << 32 | u
+      float e, x, y, z;
+      bool operator<(const Hit& h) const { return key < h.key; }
+    };
+    /// Straight line fit with running sums, z relative to the first cluster
+    struct LineFit  {
+      double z0 = 0, n = 0, sz = 0, szz = 0, sp = 0, szp = 0, spp = 0;
+      double a = 0, b = 0;
+      void add(double z, double p)  {
+        if ( n == 0 ) z0 = z;
+        z -= z0;
+        n += 1; sz += z; szz += z*z; sp += p; szp += z*p; spp += p*p;
+        const double d = n*szz - sz*sz;
+        if ( d > 0 )  { b = (n*szp - sz*sp)/d; a = (sp - b*sz)/n; }
+        else          { b = 0; a = sp/n; }
+      }
+      double predict(double z) const  { return a + b*(z - z0); }
+      double chi2() const  {
+        return std::max(0e0, spp - 2*a*sp - 2*b*szp + a*a*n + 2*a*b*sz + b*b*szz);
+      }
+    };
+
+    FibreLayout                m_layout;
+    FibreTrackingConfig        m_cfg;
+    CellIDField                m_module, m_sublayer, m_fibre;
+    bool                       m_hasModule = false;
+    std::vector<Hit>           m_hits;
+    std::vector<FibreCluster>  m_clusters;
+    std::vector<FibrePlane>    m_planes;
+    std::vector<FibreTracklet> m_tracklets;
+    std::vector<FibreTracklet> m_candidates;
+    std::vector<std::int32_t>  m_owner;     // candidate index per cluster
+    std::vector<std::uint32_t> m_path;
+    std::size_t                m_extensions = 0;
+    bool                       m_truncated  = false;
+    // best candidate of the current seed
+    std::vector<std::uint32_t> m_bestPath;
+    LineFit                    m_bestFit;
+
+    int viewOf(long module) const  {
+      if ( module < 0 || module >= long(m_layout.moduleViews.size()) ) return VIEW_X;
+      return m_layout.moduleViews[module];
+    }
+
+    bool better(std::size_t n, double chi2) const  {
+      if ( n != m_bestPath.size() ) return n > m_bestPath.size();
+      return chi2 < m_bestFit.chi2();
+    }
+
+    void cluster()  {
+      std::sort(m_hits.begin(), m_hits.end());
+      const std::size_t nh = m_hits.size();
+      std::size_t i = 0;
+      while( i < nh )  {
+        const std::uint64_t pkey = m_hits[i].key >> 32;
+        FibrePlane plane;
+        plane.key   = pkey;
+        plane.view  = viewOf(long(pkey >> 16));
+        plane.first = std::uint32_t(m_clusters.size());
+        double ez = 0, esum = 0;
+        while( i < nh && (m_hits[i].key >> 32) == pkey )  {
+          // one run of neighbouring half-pitch positions
+          const Hit& h0 = m_hits[i];
+          FibreCluster c;
+          c.plane = std::uint32_t(m_planes.size());
+          c.umin  = c.umax = std::int32_t(h0.key & 0xFFFFFFFF);
+          double e = 0, ep = 0, ezc = 0, p = 0, zc = 0;
+          while( i < nh && (m_hits[i].key >> 32) == pkey )  {
+            const Hit& h = m_hits[i];
+            const std::int32_t u = std::int32_t(h.key & 0xFFFFFFFF);
+            if ( u - c.umax > m_cfg.maxGap + 1 ) break;
+            const double hp = plane.view == VIEW_X ? h.x : h.y;
+            e += h.e; ep += h.e*hp; ezc += h.e*h.z; p += hp; zc += h.z;
+            c.umax = u;
+            ++c.size;
+            ++i;
+          }
+          c.energy = float(e);
+          c.pos    = float(e > 0 ? ep/e : p/c.size);
+          c.z      = float(e > 0 ? ezc/e : zc/c.size);
+          ez   += e > 0 ? ezc : zc;
+          esum += e > 0 ? e : c.size;
+          m_clusters.push_back(c);
+        }
+        plane.last = std::uint32_t(m_clusters.size());
+        plane.z    = float(ez/esum);
+        std::sort(m_clusters.begin()+plane.first, m_clusters.begin()+plane.last,
+                  [](const FibreCluster& a, const FibreCluster& b) { return a.pos < b.pos; });
+        m_planes.push_back(plane);
+      }
+    }
+
+    /// Depth first extension of the current path from plane index 'ip' on
+    void follow(const std::vector<std::uint32_t>& planes, std::size_t ip, int missed, const LineFit& fit)  {
+      const double sig2 = m_cfg.resolution*m_cfg.resolution;
+      bool extended = false;
+      for( std::size_t jp = ip; jp < planes.size() && missed <= m_cfg.maxMissed; ++jp, ++missed )  {
+        const FibrePlane& pl = m_planes[planes[jp]];
+        const double pred = fit.predict(pl.z);
+        auto beg = m_clusters.begin()+pl.first, end = m_clusters.begin()+pl.last;
+        auto it  = std::lower_bound(beg, end, float(pred - m_cfg.window),
+                                    [](const FibreCluster& c, float v) { return c.pos < v; });
+        for( ; it != end && it->pos <= pred + m_cfg.window; ++it )  {
+          if ( ++m_extensions > m_cfg.maxExtensions ) { m_truncated = true; return; }
+          LineFit f = fit;
+          f.add(it->z, it->pos);
+          const int ndf = int(f.n) - 2;
+          if ( ndf > 0 && f.chi2()/sig2/ndf > m_cfg.maxChi2 ) continue;
+          extended = true;
+          m_path.push_back(std::uint32_t(it - m_clusters.begin()));
+          follow(planes, jp+1, 0, f);
+          m_path.pop_back();
+        }
+        if ( extended ) return;
+      }
+      if ( !extended && int(m_path.size()) >= m_cfg.minClusters && std::abs(fit.b) <= m_cfg.maxSlope &&
+           better(m_path.size(), fit.chi2()) )  {
+        m_bestPath = m_path;
+        m_bestFit  = fit;
+      }
+    }
+
+    void buildTracklets(int view)  {
+      std::vector<std::uint32_t> planes;
+      for( std::uint32_t p = 0; p < m_planes.size(); ++p )
+        if ( m_planes[p].view == view ) planes.push_back(p);
+      std::sort(planes.begin(), planes.end(),
+                [this](std::uint32_t a, std::uint32_t b) { return m_planes[a].z < m_planes[b].z; });
+      for( std::size_t ia = 0; ia + 1 < planes.size() && !m_truncated; ++ia )  {
+        const FibrePlane& pa = m_planes[planes[ia]];
+        for( std::size_t ib = ia+1; ib < planes.size() && ib <= ia+1+std::size_t(m_cfg.maxMissed); ++ib )  {
+          const FibrePlane& pb = m_planes[planes[ib]];
+          const double reach = m_cfg.maxSlope*std::abs(pb.z - pa.z) + m_cfg.window;
+          for( std::uint32_t ca = pa.first; ca < pa.last && !m_truncated; ++ca )  {
+            const FibreCluster& a = m_clusters[ca];
+            auto beg = m_clusters.begin()+pb.first, end = m_clusters.begin()+pb.last;
+            auto it  = std::lower_bound(beg, end, float(a.pos - reach),
+                                        [](const FibreCluster& c, float v) { return c.pos < v; });
+            for( ; it != end && it->pos <= a.pos + reach; ++it )  {
+              const std::uint32_t cb = std::uint32_t(it - m_clusters.begin());
+              // both seed clusters already on one candidate: nothing new to find
+              if ( m_owner[ca] >= 0 && m_owner[ca] == m_owner[cb] ) continue;
+              LineFit fit;
+              fit.add(a.z, a.pos);
+              fit.add(it->z, it->pos);
+              m_path.assign({ ca, cb });
+              m_bestPath.clear();
+              follow(planes, ib+1, 0, fit);
+              if ( m_bestPath.empty() ) continue;
+              FibreTracklet t;
+              t.view      = view;
+              t.z0        = m_bestFit.z0;
+              t.intercept = m_bestFit.a;
+              t.slope     = m_bestFit.b;
+              t.chi2      = m_bestFit.chi2()/(m_cfg.resolution*m_cfg.resolution);
+              t.ndf       = int(m_bestFit.n) - 2;
+              t.clusters  = m_bestPath;
+              for( auto c : t.clusters ) m_owner[c] = std::int32_t(m_candidates.size());
+              m_candidates.push_back(std::move(t));
+              if ( m_truncated ) break;
+            }
+          }
+        }
+      }
+    }
+
+    void select()  {
+      std::sort(m_candidates.begin(), m_candidates.end(), [](const FibreTracklet& a, const FibreTracklet& b)  {
+        if ( a.clusters.size() != b.clusters.size() ) return a.clusters.size() > b.clusters.size();
+        return a.chi2 < b.chi2;
+      });
+      std::vector<char> used(m_clusters.size(), 0);
+      for( auto& t : m_candidates )  {
+        bool free = true;
+        for( auto c : t.clusters ) free = free && !used[c];
+        if ( !free ) continue;
+        for( auto c : t.clusters ) used[c] = 1;
+        m_tracklets.push_back(std::move(t));
+      }
+    }
+
+  public:
+    FibreTrackletFinder(const CellIDDecoder& dec, const FibreLayout& layout, const FibreTrackingConfig& cfg = FibreTrackingConfig())
+      : m_layout(layout), m_cfg(cfg)  {
+      m_hasModule = !layout.moduleField.empty();
+      if ( m_hasModule ) m_module = dec.field(layout.moduleField);
+      m_sublayer = dec.field(layout.sublayerField);
+      m_fibre    = dec.field(layout.fibreField);
+    }
+
+    void clear()  {
+      m_hits.clear();
+      m_clusters.clear();
+      m_planes.clear();
+      m_tracklets.clear();
+      m_candidates.clear();
+      m_extensions = 0;
+      m_truncated  = false;
+    }
+
+    /// Add one fibre hit, position in mm
+    void addHit(std::uint64_t cellID, float e, float x, float y, float z)  {
+      if ( e < m_cfg.minEnergy ) return;
+      const long module = m_hasModule ? m_module.value(cellID) : 0;
+      const long sub    = m_sublayer.value(cellID);
+      const long small  = sub % 2;
+      const long fibre  = m_fibre.value(cellID) - (small ? m_layout.smallOffset : 0);
+      const std::uint64_t plane = (std::uint64_t(module) << 16) | std::uint64_t(sub / m_layout.sublayersPerPlane);
+      const std::uint64_t u     = std::uint64_t(2*fibre + small) & 0xFFFFFFFF;
+      m_hits.push_back({ (plane << 32) | u, e, x, y, z });
+    }
+
+    /// Cluster the hits of the event and build tracklets in both views
+    void process()  {
+      cluster();
+      m_owner.assign(m_clusters.size(), -1);
+      buildTracklets(VIEW_X);
+      buildTracklets(VIEW_Y);
+      select();
+    }
+
+    const std::vector<FibreCluster>&  clusters()  const { return m_clusters; }
+    const std::vector<FibrePlane>&    planes()    const { return m_planes; }
+    const std::vector<FibreTracklet>& tracklets() const { return m_tracklets; }
+    /// True if the extension budget was exhausted in this event
+    bool truncated() const { return m_truncated; }
+  };
+}
+#endif // DD4SHIP_FIBRETRACKLETS_H
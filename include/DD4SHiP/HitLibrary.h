@@ -0,0 +1,277 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Memory-mapped library of background hit events for overlay.
+//
+// File layout (native byte order):
+//   header | hits | event index | collection names
+// The hits of one event and collection are contiguous LibraryHit records
+// sorted by cellID and time, one record per cell and time bin of the
+// library (header timeBin): the energy of the contributions in that bin at
+// the time of the earliest one. The index holds the first hit of every
+// (event, collection) pair plus the end. The library is written once
+// (scripts/buildHitLibrary.C) and mapped read-only by every overlay job, so
+// sampling a background event costs no I/O beyond the pages it touches.
+//
+// overlay() merges two sorted hit ranges in one linear pass into one
+// record per cell, summing the energies of equal cellIDs. The time window
+// applies to every background record, so a cell only gets the part of its
+// energy deposited inside the window, to within the time bin.
+//
+// No ROOT, DD4hep or Geant4 dependency.
+//
+//==========================================================================
+#ifndef DD4SHIP_HITLIBRARY_H
+#define DD4SHIP_HITLIBRARY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dd4ship {
+
+  /// One calorimeter cell of a library event: 16 bytes
+  struct LibraryHit  {
+    std::uint64_t cellID;
+    float         energy;    // MeV
+    float         time;      // earliest contribution [ns]
+  };
+
+  /// Sort hits by cellID and time and merge those of the same cell and time bin (energies
+  /// summed, earliest time). timeBin <= 0: one record per cell
+  inline void sortAndMergeHits(std::vector<LibraryHit>& hits, float timeBin = 0.f)  {
+    std::sort(hits.begin(), hits.end(), [](const LibraryHit& a, const LibraryHit& b)  {
+        return a.cellID != b.cellID ? a.cellID < b.cellID : a.time < b.time;
+      });
+    auto bin = [timeBin](float t)  { return timeBin > 0.f ? long(std::floor(t/timeBin)) : 0L; };
+    std::size_t n = 0;
+    for( std::size_t i = 0; i < hits.size(); ++i )  {
+      if ( n > 0 && hits[n-1].cellID == hits[i].cellID && bin(hits[n-1].time) == bin(hits[i].time) )  {
+        hits[n-1].energy += hits[i].energy;
+        hits[n-1].time    = std::min(hits[n-1].time, hits[i].time);
+        continue;
+      }
+      hits[n++] = hits[i];
+    }
+    hits.resize(n);
+  }
+
+  /// out = signal + background, both sorted by cellID, with one record per cell. Background
+  /// records are shifted by 'shift' and only taken if tmin <= time < tmax.
+  inline void overlay(const LibraryHit* s, const LibraryHit* se, const LibraryHit* b, const LibraryHit* be,
+                      float shift, float tmin, float tmax, std::vector<LibraryHit>& out)  {
+    out.clear();
+    out.reserve((se - s) + (be - b));
+    auto add = [&out](std::uint64_t cellID, float energy, float time)  {
+      if ( !out.empty() && out.back().cellID == cellID )  {
+        out.back().energy += energy;
+        out.back().time    = std::min(out.back().time, time);
+      }
+      else  {
+        out.push_back(LibraryHit{ cellID, energy, time });
+      }
+    };
+    while( s != se || b != be )  {
+      if ( b != be )  {
+        const float t = b->time + shift;
+        if ( t < tmin || t >= tmax )  {
+          ++b;
+          continue;
+        }
+      }
+      if ( b == be || (s != se && s->cellID <= b->cellID) )  {
+        add(s->cellID, s->energy, s->time);
+        ++s;
+      }
+      else  {
+        add(b->cellID, b->energy, b->time + shift);
+        ++b;
+      }
+    }
+  }
+
+  struct HitLibraryHeader  {
+    char          magic[8];          // "DD4SHLIB"
+    std::uint32_t version;
+    std::uint32_t nCollections;
+    std::uint64_t nEvents;
+    std::uint64_t nHits;
+    std::uint64_t indexOffset;       // bytes from the start of the file
+    std::uint64_t namesOffset;
+    float         timeBin;           // [ns], 0: one record per cell
+    std::uint32_t reserved;
+  };
+
+  static constexpr std::uint32_t HITLIBRARY_VERSION = 2;
+  static constexpr std::size_t   HITLIBRARY_NAMELEN = 64;
+
+  class HitLibraryWriter  {
+    std::FILE*                 m_file = nullptr;
+    std::string                m_path;
+    std::vector<std::string>   m_collections;
+    std::vector<std::uint64_t> m_index;
+    std::uint64_t              m_nHits = 0;
+    float                      m_timeBin;
+
+    void write(const void* data, std::size_t size)  {
+      if ( size && std::fwrite(data, 1, size, m_file) != size )
+        throw std::runtime_error("HitLibraryWriter: write failed for "+m_path);
+    }
+
+  public:
+    /// Records are merged per cell and time bin of 'timeBin' ns (<= 0: one record per cell)
+    HitLibraryWriter(const std::string& path, const std::vector<std::string>& collections, float timeBin = 1.f)
+      : m_path(path), m_collections(collections), m_timeBin(std::max(0.f, timeBin))  {
+      for( const auto& c : collections )
+        if ( c.size() >= HITLIBRARY_NAMELEN )
+          throw std::runtime_error("HitLibraryWriter: collection name too long: "+c);
+      m_file = std::fopen(path.c_str(), "wb");
+      if ( !m_file ) throw std::runtime_error("HitLibraryWriter: cannot create "+path);
+      HitLibraryHeader head;
+      std::memset(&head, 0, sizeof(head));
+      write(&head, sizeof(head));
+    }
+    HitLibraryWriter(const HitLibraryWriter&) = delete;
+    HitLibraryWriter& operator=(const HitLibraryWriter&) = delete;
+    ~HitLibraryWriter()  {
+      try { close(); } catch(...) {}
+    }
+
+    /// Append one event: hits[c] are the hits of collection c, in any order, e.g. one per
+    /// MC contribution
+    void addEvent(std::vector<std::vector<LibraryHit> >& hits)  {
+      if ( hits.size() != m_collections.size() )
+        throw std::runtime_error("HitLibraryWriter: wrong number of collections");
+      for( auto& h : hits )  {
+        sortAndMergeHits(h, m_timeBin);
+        m_index.push_back(m_nHits);
+        write(h.data(), h.size()*sizeof(LibraryHit));
+        m_nHits += h.size();
+      }
+    }
+
+    std::uint64_t events() const  {
+      return m_collections.empty() ? 0 : m_index.size()/m_collections.size();
+    }
+
+    /// Write index, names and header
+    void close()  {
+      if ( !m_file ) return;
+      HitLibraryHeader head;
+      std::memset(&head, 0, sizeof(head));
+      std::memcpy(head.magic, "DD4SHLIB", 8);
+      head.version      = HITLIBRARY_VERSION;
+      head.nCollections = std::uint32_t(m_collections.size());
+      head.nEvents      = events();
+      head.nHits        = m_nHits;
+      head.indexOffset  = sizeof(head) + m_nHits*sizeof(LibraryHit);
+      head.namesOffset  = head.indexOffset + (m_index.size()+1)*sizeof(std::uint64_t);
+      head.timeBin      = m_timeBin;
+      m_index.push_back(m_nHits);
+      write(m_index.data(), m_index.size()*sizeof(std::uint64_t));
+      for( const auto& c : m_collections )  {
+        char name[HITLIBRARY_NAMELEN] = { 0 };
+        std::memcpy(name, c.data(), c.size());
+        write(name, sizeof(name));
+      }
+      std::fseek(m_file, 0, SEEK_SET);
+      write(&head, sizeof(head));
+      const bool ok = std::fclose(m_file) == 0;
+      m_file = nullptr;
+      if ( !ok ) throw std::runtime_error("HitLibraryWriter: close failed for "+m_path);
+    }
+  };
+
+  class HitLibrary  {
+    void*                      m_base  = nullptr;
+    std::size_t                m_size  = 0;
+    const HitLibraryHeader*    m_head  = nullptr;
+    const LibraryHit*          m_hits  = nullptr;
+    const std::uint64_t*       m_index = nullptr;
+    std::vector<std::string>   m_collections;
+
+  public:
+    struct Range  {
+      const LibraryHit* begin;
+      const LibraryHit* end;
+      std::size_t size() const  { return std::size_t(end - begin); }
+    };
+
+    explicit HitLibrary(const std::string& path)  {
+      int fd = ::open(path.c_str(), O_RDONLY);
+      if ( fd < 0 ) throw std::runtime_error("HitLibrary: cannot open "+path);
+      struct stat st;
+      if ( ::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(HitLibraryHeader) )  {
+        ::close(fd);
+        throw std::runtime_error("HitLibrary: not a hit library: "+path);
+      }
+      m_size = std::size_t(st.st_size);
+      m_base = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if ( m_base == MAP_FAILED )  {
+        m_base = nullptr;
+        throw std::runtime_error("HitLibrary: mmap failed for "+path);
+      }
+      // events are sampled at random: no read-ahead
+      ::madvise(m_base, m_size, MADV_RANDOM);
+      const char* base = static_cast<const char*>(m_base);
+      m_head = reinterpret_cast<const HitLibraryHeader*>(base);
+      if ( std::memcmp(m_head->magic, "DD4SHLIB", 8) != 0 || m_head->version != HITLIBRARY_VERSION
+           || m_head->namesOffset + m_head->nCollections*HITLIBRARY_NAMELEN > m_size )  {
+        ::munmap(m_base, m_size);
+        m_base = nullptr;
+        throw std::runtime_error("HitLibrary: bad or incomplete hit library "+path);
+      }
+      m_hits  = reinterpret_cast<const LibraryHit*>(base + sizeof(HitLibraryHeader));
+      m_index = reinterpret_cast<const std::uint64_t*>(base + m_head->indexOffset);
+      for( std::uint32_t c = 0; c < m_head->nCollections; ++c )  {
+        const char* n = base + m_head->namesOffset + c*HITLIBRARY_NAMELEN;
+        m_collections.emplace_back(n, strnlen(n, HITLIBRARY_NAMELEN));
+      }
+    }
+    HitLibrary(const HitLibrary&) = delete;
+    HitLibrary& operator=(const HitLibrary&) = delete;
+    ~HitLibrary()  {
+      if ( m_base ) ::munmap(m_base, m_size);
+    }
+
+    std::uint64_t events() const       { return m_head->nEvents; }
+    std::uint64_t hits() const         { return m_head->nHits; }
+    float         timeBin() const      { return m_head->timeBin; }
+    const std::vector<std::string>& collections() const  { return m_collections; }
+
+    /// Index of a collection, -1 if the library does not have it
+    int collection(const std::string& name) const  {
+      for( std::size_t c = 0; c < m_collections.size(); ++c )
+        if ( m_collections[c] == name ) return int(c);
+      return -1;
+    }
+
+    /// Hits of one event and collection, sorted by cellID and time
+    Range hits(std::uint64_t event, int coll) const  {
+      const std::uint64_t i = event*m_head->nCollections + std::uint64_t(coll);
+      return Range{ m_hits + m_index[i], m_hits + m_index[i+1] };
+    }
+  };
+}
+#endif // DD4SHIP_HITLIBRARY_H
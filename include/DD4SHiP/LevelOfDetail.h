@@ -0,0 +1,86 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Level-of-detail helpers shared by the SplitCal builders.
+//
+// With lod="coarse" on the <detector> element the builders do not place
+// individual bars or fibres. Every bar layer and HPL box becomes a single
+// sensitive slab made of a mixture with the same mass as the detailed
+// layer, so the splitcal_layer IDs and the longitudinal material profile
+// are preserved while the volume count drops by orders of magnitude.
+//
+//==========================================================================
+#ifndef DD4SHIP_LEVELOFDETAIL_H
+#define DD4SHIP_LEVELOFDETAIL_H
+
+#include <DD4hep/DetFactoryHelper.h>
+#include <DD4hep/Printout.h>
+
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace dd4ship {
+
+  enum LevelOfDetail { LOD_FINE = 0, LOD_COARSE = 1 };
+
+  /// Read the optional 'lod' attribute of a detector element ("fine" by default)
+  inline LevelOfDetail levelOfDetail(dd4hep::xml::DetElement x_det)  {
+    if ( !x_det.hasAttr(_Unicode(lod)) ) return LOD_FINE;
+    const std::string lod = x_det.attr<std::string>(_Unicode(lod));
+    if ( lod == "fine"   || lod == "0" ) return LOD_FINE;
+    if ( lod == "coarse" || lod == "1" ) return LOD_COARSE;
+    throw std::runtime_error("DD4SHiP: "+x_det.nameStr()+": unknown lod '"+lod+"' (use fine or coarse)");
+  }
+
+  /// One constituent of a homogenised slab: material and its volume fraction
+  struct SlabComponent  {
+    dd4hep::Material material;
+    double           volumeFraction;
+  };
+
+  /// Build (or reuse) a mixture with the mass of the given volume fractions
+  inline dd4hep::Material homogenisedMaterial(dd4hep::Detector& description,
+                                              const std::string& name,
+                                              const std::vector<SlabComponent>& components)  {
+    TGeoManager& mgr = description.manager();
+    if ( TGeoMedium* med = mgr.GetMedium(name.c_str()) ) return dd4hep::Material(med);
+
+    double density = 0e0;
+    for( const auto& c : components )
+      density += c.volumeFraction * c.material->GetMaterial()->GetDensity();
+
+    TGeoMixture* mix = new TGeoMixture(name.c_str(), components.size(), density);
+    for( const auto& c : components )  {
+      if ( c.volumeFraction <= 0e0 ) continue;
+      const double w = c.volumeFraction * c.material->GetMaterial()->GetDensity() / density;
+      mix->AddElement(c.material->GetMaterial(), w);
+    }
+    TGeoMedium* med = new TGeoMedium(name.c_str(), mgr.GetListOfMedia()->GetSize()+1, mix);
+    dd4hep::printout(dd4hep::INFO, "DD4SHiP_LOD", "%s: homogenised density %7.4f g/cm3 from %ld materials",
+                     name.c_str(), density, components.size());
+    return dd4hep::Material(med);
+  }
+
+  /// Slab of bars: bars of material 'bar' fill 'fill' of the layer, the rest is air
+  inline dd4hep::Material barLayerMaterial(dd4hep::Detector& description, const std::string& name,
+                                           dd4hep::Material bar, double fill)  {
+    if ( fill > 1e0 ) fill = 1e0;
+    return homogenisedMaterial(description, name, { {bar, fill}, {description.air(), 1e0-fill} });
+  }
+}
+#endif // DD4SHIP_LEVELOFDETAIL_H
@@ -0,0 +1,195 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Per-channel MIP calibration: deposits are histogrammed per channel into
+// one dense channel-major array (channel * nbins + bin), then every channel
+// is fitted with a Moyal approximation of the Landau-Gauss convolution.
+//
+// The fit is a binned Poisson likelihood scanned over a grid of (MPV, width)
+// with the normalisation solved analytically. The inner loop runs over the
+// contiguous bins of one channel; channels are distributed over threads.
+// GCC and Clang do not vectorise its std::exp calls without -ffast-math or
+// a vector math library, neither of which this build uses.
+//
+// Channels are cellIDs with the segmentation fields (x, y) masked out,
+// i.e. one channel per bar or fibre.
+//
+//==========================================================================
+#ifndef DD4SHIP_MIPCALIBRATION_H
+#define DD4SHIP_MIPCALIBRATION_H
+
+#include <DD4SHiP/CellIDDecoder.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dd4ship {
+
+  struct MIPFitResult  {
+    float mpv     = 0;   // most probable value [MeV]
+    float width   = 0;   // Moyal width (Landau scale folded with the Gaussian smearing) [MeV]
+    float entries = 0;
+    int   status  = -1;  // 0: ok, 1: too few entries, 2: peak at histogram edge
+  };
+
+  class MIPCalibration  {
+  public:
+    struct Channel  {
+      std::string   collection;
+      std::uint64_t key;     // cellID with x/y masked out
+    };
+
+  private:
+    int                    m_nbins;
+    float                  m_emin, m_emax, m_binw;
+    std::vector<float>     m_centres;
+    std::vector<Channel>   m_channels;
+    std::vector<float>     m_counts;           // channel-major histograms
+    std::unordered_map<std::uint64_t, std::uint32_t> m_index;
+    std::unordered_map<std::string, std::uint64_t>   m_masks;
+    std::unordered_map<std::string, std::uint32_t>   m_collectionIds;
+    // per-event accumulation
+    std::vector<float>         m_eventSum;
+    std::vector<std::uint32_t> m_touched;
+    std::vector<std::uint32_t> m_touchedIn;        // event generation a channel was last touched in
+    std::uint32_t              m_generation = 1;
+
+    static std::uint64_t channelMask(const CellIDDecoder& dec)  {
+      std::uint64_t mask = 0;
+      for( const auto& f : dec.fields() )
+        if ( f.name != "x" && f.name != "y" ) mask |= f.mask;
+      return mask;
+    }
+
+  public:
+    MIPCalibration(int nbins = 200, float emin = 0.f, float emax = 10.f)
+      : m_nbins(nbins), m_emin(emin), m_emax(emax), m_binw((emax-emin)/nbins)  {
+      for( int i = 0; i < nbins; ++i ) m_centres.push_back(emin + (i+0.5f)*m_binw);
+    }
+
+    int    nbins()   const  { return m_nbins; }
+    std::size_t size() const { return m_channels.size(); }
+    const std::vector<Channel>& channels() const { return m_channels; }
+    const float* histogram(std::size_t ch) const { return &m_counts[ch*m_nbins]; }
+
+    /// Register a collection with its cellID descriptor
+    void addCollection(const std::string& name, const CellIDDecoder& dec)  {
+      m_masks[name] = channelMask(dec);
+      m_collectionIds.emplace(name, std::uint32_t(m_collectionIds.size()));
+    }
+
+    /// Accumulate one hit of the current event
+    void add(const std::string& collection, std::uint64_t cellID, float edep)  {
+      auto im = m_masks.find(collection);
+      if ( im == m_masks.end() ) return;
+      const std::uint64_t key  = cellID & im->second;
+      // collections may share cellID values: fold the collection into the lookup key
+      const std::uint64_t ukey = key ^ (std::uint64_t(m_collectionIds[collection]) << 58);
+      auto it = m_index.find(ukey);
+      std::uint32_t ch;
+      if ( it == m_index.end() )  {
+        ch = std::uint32_t(m_channels.size());
+        m_index.emplace(ukey, ch);
+        m_channels.push_back({collection, key});
+        m_counts.resize(m_counts.size() + m_nbins, 0.f);
+        m_eventSum.push_back(0.f);
+        m_touchedIn.push_back(0);
+      }
+      else ch = it->second;
+      if ( m_touchedIn[ch] != m_generation )  {
+        m_touchedIn[ch] = m_generation;
+        m_touched.push_back(ch);
+      }
+      m_eventSum[ch] += edep;
+    }
+
+    /// Close the current event: fill the channel sums into the histograms
+    void endEvent()  {
+      for( std::uint32_t ch : m_touched )  {
+        const int bin = int((m_eventSum[ch] - m_emin) / m_binw);
+        if ( bin >= 0 && bin < m_nbins ) m_counts[std::size_t(ch)*m_nbins + bin] += 1.f;
+        m_eventSum[ch] = 0.f;
+      }
+      m_touched.clear();
+      ++m_generation;
+    }
+
+    /// Fit one histogram
+    MIPFitResult fit(const float* h, int minEntries = 50) const  {
+      MIPFitResult r;
+      int   peak = 0;
+      for( int i = 0; i < m_nbins; ++i )  {
+        r.entries += h[i];
+        if ( h[i] > h[peak] ) peak = i;
+      }
+      if ( r.entries < minEntries )  { r.status = 1; return r; }
+
+      // Scan grid: MPV around the peak bin in quarter bins, width logarithmically
+      const int   nmpv = 33, nwid = 24;
+      float best = -1e30f, bestMpv = m_centres[peak], bestWid = m_binw;
+      for( int iw = 0; iw < nwid; ++iw )  {
+        const float wid = m_binw * 0.5f * std::pow(1.25f, float(iw));
+        const float inv = 1.f / wid;
+        for( int im = 0; im < nmpv; ++im )  {
+          const float mpv = m_centres[peak] + (im - nmpv/2) * 0.25f * m_binw;
+          // log L = sum h*log(norm*f) - norm*sum f, with norm*sum f = entries
+          float sf = 0.f, shl = 0.f;
+          for( int i = 0; i < m_nbins; ++i )  {
+            const float l    = std::max((m_centres[i] - mpv) * inv, -20.f);
+            const float logf = -0.5f * (l + std::exp(-l));
+            sf  += std::exp(logf);
+            shl += h[i] * logf;
+          }
+          const float ll = shl + r.entries * std::log(r.entries / (sf + 1e-30f));
+          if ( ll > best )  { best = ll; bestMpv = mpv; bestWid = wid; }
+        }
+      }
+      r.mpv    = bestMpv;
+      r.width  = bestWid;
+      r.status = (peak == 0 || peak == m_nbins-1) ? 2 : 0;
+      return r;
+    }
+
+    /// Fit all channels using nthreads threads
+    std::vector<MIPFitResult> fitAll(unsigned nthreads = std::thread::hardware_concurrency(), int minEntries = 50) const  {
+      std::vector<MIPFitResult> res(m_channels.size());
+      std::atomic<std::size_t> next(0);
+      auto work = [&]()  {
+        for( std::size_t ch; (ch = next.fetch_add(64)) < res.size(); )
+          for( std::size_t c = ch; c < std::min(ch+64, res.size()); ++c )
+            res[c] = fit(histogram(c), minEntries);
+      };
+      std::vector<std::thread> pool;
+      for( unsigned t = 1; t < std::max(1u, nthreads); ++t ) pool.emplace_back(work);
+      work();
+      for( auto& t : pool ) t.join();
+      return res;
+    }
+
+    /// Write the calibration table as CSV
+    void write(std::ostream& os, const std::vector<MIPFitResult>& res) const  {
+      os << "collection,channel,mpv_MeV,width_MeV,entries,status\n";
+      for( std::size_t c = 0; c < res.size(); ++c )
+        os << m_channels[c].collection << "," << m_channels[c].key << ","
+           << res[c].mpv << "," << res[c].width << "," << res[c].entries << "," << res[c].status << "\n";
+    }
+  };
+}
+#endif // DD4SHIP_MIPCALIBRATION_H
@@ -0,0 +1,38 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// One place to switch on ROOT's thread safety for the DD4SHiP code that
+// creates, fills or reads ROOT objects outside the main thread: the Geant4
+// actions writing their own files or booking histograms in worker threads,
+// and the Python module reading trees with the GIL released.
+//
+// Call enableROOTThreadSafety() from the constructor of such an action,
+// i.e. before the first ROOT object is touched from another thread.
+//
+//==========================================================================
+#ifndef DD4SHIP_ROOTTHREADS_H
+#define DD4SHIP_ROOTTHREADS_H
+
+#include <TROOT.h>
+
+#include <mutex>
+
+namespace dd4ship {
+
+  /// Enable ROOT thread safety once per process
+  inline void enableROOTThreadSafety()  {
+    static std::once_flag once;
+    std::call_once(once, [] { ROOT::EnableThreadSafety(); });
+  }
+}
+#endif // DD4SHIP_ROOTTHREADS_H
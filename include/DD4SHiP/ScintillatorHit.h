@@ -0,0 +1,40 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Calorimeter hit of the DD4SHiPScintillatorLight sensitive detector:
+// a Geant4Calorimeter::Hit with the Birks-saturated visible energy and the
+// expected number of photoelectrons at both ends of the bar or fibre.
+// The ROOT dictionary is part of libDD4SHIPG4.
+//
+//==========================================================================
+#ifndef DD4SHIP_SCINTILLATORHIT_H
+#define DD4SHIP_SCINTILLATORHIT_H
+
+#include <DDG4/Geant4Data.h>
+
+namespace dd4ship {
+
+  class ScintillatorHit : public dd4hep::sim::Geant4Calorimeter::Hit  {
+  public:
+    /// Birks-saturated deposit [MeV]
+    double visibleEnergy    { 0 };
+    /// Expected photoelectrons at the negative (A) and positive (B) end of the long axis
+    double photoelectronsA  { 0 };
+    double photoelectronsB  { 0 };
+
+    ScintillatorHit() = default;
+    ScintillatorHit(const dd4hep::Position& cell_pos) : dd4hep::sim::Geant4Calorimeter::Hit(cell_pos)  {}
+    virtual ~ScintillatorHit() = default;
+  };
+}
+#endif // DD4SHIP_SCINTILLATORHIT_H
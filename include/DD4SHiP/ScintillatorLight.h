@@ -0,0 +1,87 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Parametrised light yield of the scintillator bars and fibres, used
+// instead of optical photon tracking.
+//
+// A deposit dE over a step of length dx gives the visible energy
+// dE / (1 + kB dE/dx) (Birks). The fraction of its light reaching each end
+// of the bar is a two-component exponential in the distance to that end,
+//
+//   T(d) = (1-f) exp(-d/lambda) + f exp(-d/lambda_short),
+//
+// tabulated once per bar length so that a step costs one table lookup.
+// End A is the negative end of the bar's long local axis, end B the
+// positive one.
+//
+//==========================================================================
+#ifndef DD4SHIP_SCINTILLATORLIGHT_H
+#define DD4SHIP_SCINTILLATORLIGHT_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace dd4ship {
+
+  struct ScintillatorLightConfig  {
+    double birksConstant   = 0.126;   // kB [mm/MeV], polyvinyltoluene and polystyrene
+    double lightYield      = 15.0;    // photoelectrons per MeV of visible energy at zero distance
+    double attLength       = 3500.;   // long attenuation component [mm]
+    double attLengthShort  = 250.;    // short attenuation component [mm]
+    double shortFraction   = 0.25;    // weight of the short component
+    int    bins            = 512;     // table bins along the bar
+  };
+
+  /// Visible energy of a deposit 'edep' [MeV] over a step of 'length' [mm]
+  inline double birksVisibleEnergy(double edep, double length, double kB)  {
+    if ( edep <= 0e0 || length <= 0e0 || kB <= 0e0 ) return edep;
+    return edep / (1e0 + kB*edep/length);
+  }
+
+  /// Photoelectrons per MeV of visible energy at both ends, binned along the bar
+  class AttenuationTable  {
+    double             m_lo     = 0;
+    double             m_invBin = 0;
+    int                m_bins   = 1;
+    std::vector<float> m_endA, m_endB;
+
+  public:
+    AttenuationTable() = default;
+    AttenuationTable(double halfLength, const ScintillatorLightConfig& cfg)
+      : m_lo(-halfLength), m_bins(std::max(cfg.bins, 1))  {
+      const double width = 2e0*halfLength/m_bins;
+      m_invBin = width > 0 ? 1e0/width : 0e0;
+      m_endA.resize(m_bins);
+      m_endB.resize(m_bins);
+      auto transmission = [&cfg](double d)  {
+        const double l = cfg.attLength      > 0 ? std::exp(-d/cfg.attLength)      : 1e0;
+        const double s = cfg.attLengthShort > 0 ? std::exp(-d/cfg.attLengthShort) : 1e0;
+        return (1e0-cfg.shortFraction)*l + cfg.shortFraction*s;
+      };
+      for( int i = 0; i < m_bins; ++i )  {
+        const double u = m_lo + (i+0.5)*width;
+        m_endA[i] = float(cfg.lightYield*transmission(u + halfLength));
+        m_endB[i] = float(cfg.lightYield*transmission(halfLength - u));
+      }
+    }
+
+    /// Photoelectrons per MeV at end A and end B for position u along the bar
+    void lookup(double u, float& a, float& b) const  {
+      const int i = std::min(std::max(int((u - m_lo)*m_invBin), 0), m_bins-1);
+      a = m_endA[i];
+      b = m_endB[i];
+    }
+  };
+}
+#endif // DD4SHIP_SCINTILLATORLIGHT_H
@@ -0,0 +1,191 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Lock-free single-producer ring of hit records in POSIX shared memory.
+//
+// The producer (the DD4SHiPHitStream event action) never waits: when the
+// ring is full the oldest records are overwritten. Every slot carries a
+// sequence number written after the payload, so a consumer detects records
+// that were overwritten while it was reading and skips ahead.
+//
+// No ROOT, DD4hep or Geant4 dependency: the header is shared by the Geant4
+// plugin and by scripts/monitorHits.C.
+//
+//==========================================================================
+#ifndef DD4SHIP_SHAREDHITRING_H
+#define DD4SHIP_SHAREDHITRING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dd4ship {
+
+  /// Compact hit summary: one per hit, 32 bytes
+  struct HitRecord  {
+    std::uint64_t cellID;
+    std::uint32_t event;
+    float         edep;      // MeV
+    float         x, y, z;   // mm
+    std::uint32_t flags;     // bit 0: last hit of the event, bit 1: no hit (empty event marker)
+  };
+
+  class SharedHitRing  {
+  public:
+    enum ReadStatus { READ_OK, READ_EMPTY, READ_LOST };
+    static constexpr std::uint32_t MAGIC   = 0x53484950;  // "SHIP"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t LAST_HIT    = 1;
+    static constexpr std::uint32_t EMPTY_EVENT = 2;
+
+  private:
+    struct Slot    {
+      std::atomic<std::uint64_t> seq;
+      HitRecord                  record;
+    };
+    struct Header  {
+      std::uint32_t              magic;
+      std::uint32_t              version;
+      std::uint64_t              capacity;
+      alignas(64) std::atomic<std::uint64_t> head;     // next sequence to write
+      alignas(64) std::atomic<std::uint64_t> events;   // completed events
+    };
+
+    std::string  m_name;
+    void*        m_base     = nullptr;
+    std::size_t  m_size     = 0;
+    bool         m_owner    = false;
+    Header*      m_header   = nullptr;
+    Slot*        m_slots    = nullptr;
+    std::uint64_t m_mask    = 0;
+
+    static std::size_t segmentSize(std::uint64_t capacity)  {
+      return sizeof(Header) + capacity * sizeof(Slot);
+    }
+    void map(int fd, std::size_t size, int prot)  {
+      m_base = ::mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if ( m_base == MAP_FAILED )  {
+        m_base = nullptr;
+        throw std::runtime_error("SharedHitRing: mmap failed for "+m_name);
+      }
+      m_size   = size;
+      m_header = static_cast<Header*>(m_base);
+      m_slots  = reinterpret_cast<Slot*>(static_cast<char*>(m_base) + sizeof(Header));
+    }
+
+  public:
+    SharedHitRing() = default;
+    SharedHitRing(const SharedHitRing&) = delete;
+    SharedHitRing& operator=(const SharedHitRing&) = delete;
+    ~SharedHitRing()  {
+      if ( m_base ) ::munmap(m_base, m_size);
+      if ( m_owner ) ::shm_unlink(m_name.c_str());
+    }
+
+    /// Producer side: create (or recreate) the segment. Capacity is rounded up to a power of 2
+    void create(const std::string& name, std::uint64_t capacity, bool unlinkOnClose = true)  {
+      std::uint64_t cap = 1;
+      while( cap < capacity ) cap <<= 1;
+      m_name = name;
+      ::shm_unlink(name.c_str());
+      int fd = ::shm_open(name.c_str(), O_CREAT|O_RDWR, 0644);
+      if ( fd < 0 ) throw std::runtime_error("SharedHitRing: shm_open failed for "+name);
+      if ( ::ftruncate(fd, segmentSize(cap)) != 0 )  {
+        ::close(fd);
+        throw std::runtime_error("SharedHitRing: ftruncate failed for "+name);
+      }
+      map(fd, segmentSize(cap), PROT_READ|PROT_WRITE);
+      m_owner = unlinkOnClose;
+      m_mask  = cap - 1;
+      std::memset(m_base, 0, m_size);
+      m_header->capacity = cap;
+      m_header->version  = VERSION;
+      m_header->head.store(0, std::memory_order_relaxed);
+      m_header->events.store(0, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      m_header->magic    = MAGIC;
+    }
+
+    /// Consumer side: attach read-only to an existing segment
+    void open(const std::string& name)  {
+      m_name = name;
+      int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+      if ( fd < 0 ) throw std::runtime_error("SharedHitRing: no segment "+name);
+      struct stat st;
+      if ( ::fstat(fd, &st) != 0 || std::size_t(st.st_size) < sizeof(Header) )  {
+        ::close(fd);
+        throw std::runtime_error("SharedHitRing: bad segment "+name);
+      }
+      map(fd, st.st_size, PROT_READ);
+      if ( m_header->magic != MAGIC || m_header->version != VERSION ||
+           segmentSize(m_header->capacity) > m_size )
+        throw std::runtime_error("SharedHitRing: incompatible segment "+name);
+      m_mask = m_header->capacity - 1;
+    }
+
+    bool          isOpen()   const { return m_base != nullptr; }
+    std::uint64_t capacity() const { return m_header->capacity; }
+    std::uint64_t head()     const { return m_header->head.load(std::memory_order_acquire); }
+    std::uint64_t events()   const { return m_header->events.load(std::memory_order_acquire); }
+
+    /// Producer: append one record. Never blocks, overwrites the oldest slot
+    void push(const HitRecord& rec)  {
+      const std::uint64_t n = m_header->head.load(std::memory_order_relaxed);
+      Slot& s = m_slots[n & m_mask];
+      s.seq.store(2*n+1, std::memory_order_relaxed);       // odd: being written
+      std::atomic_thread_fence(std::memory_order_release);
+      s.record = rec;
+      s.seq.store(2*n+2, std::memory_order_release);       // even: complete
+      m_header->head.store(n+1, std::memory_order_release);
+    }
+    /// Producer: mark the end of an event
+    void endEvent()  {
+      m_header->events.fetch_add(1, std::memory_order_release);
+    }
+
+    /// Consumer: read the record with sequence 'cursor'. On READ_LOST the cursor
+    /// is moved to the oldest record still available.
+    ReadStatus read(std::uint64_t& cursor, HitRecord& rec) const  {
+      const std::uint64_t h = head();
+      if ( cursor >= h ) return READ_EMPTY;
+      if ( h - cursor > m_header->capacity )  {
+        cursor = h - m_header->capacity;
+        return READ_LOST;
+      }
+      const Slot& s = m_slots[cursor & m_mask];
+      const std::uint64_t s1 = s.seq.load(std::memory_order_acquire);
+      if ( s1 != 2*cursor+2 )  {
+        if ( s1 < 2*cursor+2 ) return READ_EMPTY;
+        cursor = head() - m_header->capacity;
+        return READ_LOST;
+      }
+      std::memcpy(&rec, &s.record, sizeof(HitRecord));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ( s.seq.load(std::memory_order_relaxed) != s1 )  {
+        cursor = head() - m_header->capacity;
+        return READ_LOST;
+      }
+      ++cursor;
+      return READ_OK;
+    }
+  };
+}
+#endif // DD4SHIP_SHAREDHITRING_H
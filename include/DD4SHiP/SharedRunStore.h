@@ -0,0 +1,81 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Run data of a Geant4 action shared by its instances in all threads.
+//
+// Every thread registers at the begin of the run and merges its own
+// counters or histograms at the end; the last thread out reports and
+// resets the merged data. All calls run under the store's lock.
+//
+//   typedef dd4ship::SharedRunStore<Sums> Store;
+//   void beginRun(const G4Run*)  { Store::instance().beginRun(); }
+//   void endRun(const G4Run*)    {
+//     Store::instance().endRun([this](Sums& s) { s += m_sums; },
+//                              [this](Sums& s) { report(s); s = Sums(); });
+//   }
+//
+// instance(key) gives one store per data type and key, e.g. per output
+// file when several instances of an action write different files.
+//
+//==========================================================================
+#ifndef DD4SHIP_SHAREDRUNSTORE_H
+#define DD4SHIP_SHAREDRUNSTORE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace dd4ship {
+
+  template <typename DATA> class SharedRunStore  {
+    std::mutex m_lock;
+    int        m_active { 0 };
+    DATA       m_data;
+
+  public:
+    /// The store of this data type and key
+    static SharedRunStore& instance(const std::string& key = "")  {
+      static std::mutex lock;
+      static std::map<std::string, std::unique_ptr<SharedRunStore> > stores;
+      std::lock_guard<std::mutex> guard(lock);
+      std::unique_ptr<SharedRunStore>& s = stores[key];
+      if ( !s ) s.reset(new SharedRunStore());
+      return *s;
+    }
+
+    /// Register a thread at the begin of the run; init(data, first) with first for the first thread in
+    template <typename INIT> void beginRun(INIT init)  {
+      std::lock_guard<std::mutex> guard(m_lock);
+      const bool first = m_active++ == 0;
+      init(m_data, first);
+    }
+    void beginRun()  {
+      beginRun([](DATA&, bool) {});
+    }
+
+    /// Merge a thread at the end of the run; the last thread out calls report(data)
+    template <typename MERGE, typename REPORT> void endRun(MERGE merge, REPORT report)  {
+      std::lock_guard<std::mutex> guard(m_lock);
+      merge(m_data);
+      if ( --m_active == 0 ) report(m_data);
+    }
+
+    /// Access to the shared data during the run
+    template <typename FUNC> void locked(FUNC func)  {
+      std::lock_guard<std::mutex> guard(m_lock);
+      func(m_data);
+    }
+  };
+}
+#endif // DD4SHIP_SHAREDRUNSTORE_H
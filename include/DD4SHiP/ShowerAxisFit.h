@@ -0,0 +1,246 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Shower axis and pointing fit from the high granularity SplitCal layers
+// (thin bars, codes 3/4, and HPL modules, codes 5/6).
+//
+// Every layer contributes one energy weighted centroid of the coordinate it
+// measures (odd codes: y, even codes: x). Per view the centroids are fitted
+// with a straight line pos = a + b*(z - zref) by iteratively reweighted
+// least squares with Huber weights, so that single layers dominated by
+// shower fluctuations or overlapping particles do not pull the axis.
+//
+// The residual scale of the Huber weights and the centroid error are
+// floored at the configured resolution: with two layers per view, or
+// centroids exactly on a line, the residuals vanish and would otherwise
+// give zero weights or zero errors.
+//
+// Events are fitted in batches: centroids are stored layer-major with the
+// event as the contiguous index, so every loop of the fit runs over events.
+//
+//==========================================================================
+#ifndef DD4SHIP_SHOWERAXISFIT_H
+#define DD4SHIP_SHOWERAXISFIT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dd4ship {
+
+  enum AxisView  { AXIS_X = 0, AXIS_Y = 1 };
+
+  /// View of each layer index: thin bars are numbered by stack position,
+  /// HPL modules by their count in the stack. -1: not a high granularity layer
+  inline std::vector<int> axisViews(const std::string& layerCodes, char codeY, char codeX, bool byStackIndex)  {
+    std::vector<int> views;
+    for( char c : layerCodes )  {
+      if ( c == codeY )      views.push_back(AXIS_Y);
+      else if ( c == codeX ) views.push_back(AXIS_X);
+      else if ( byStackIndex ) views.push_back(-1);
+    }
+    return views;
+  }
+
+  struct ShowerAxisConfig  {
+    double zref       = 0;     // reference plane of the intercepts [mm]
+    int    iterations = 5;     // reweighting iterations
+    double huberK     = 1.5;   // Huber threshold in units of the residual RMS
+    double resolution = 3.0;   // centroid resolution, floor of the residual scale [mm]
+    float  minEnergy  = 0.f;   // minimum layer energy [MeV]
+  };
+
+  struct ShowerAxis  {
+    float tx = 0, ty = 0;             // dx/dz, dy/dz
+    float x0 = 0, y0 = 0;             // position at zref [mm]
+    float sigma_tx = 0, sigma_ty = 0;
+    float sigma_x0 = 0, sigma_y0 = 0;
+    float cov_x = 0, cov_y = 0;       // cov(x0, tx), cov(y0, ty)
+    int   nx = 0, ny = 0;             // layers used per view
+    int   status = 0;                 // bit 0/1: fewer than 2 layers in x/y
+
+    /// Unit vector along the shower axis
+    void direction(double& ux, double& uy, double& uz) const  {
+      const double n = std::sqrt(1e0 + double(tx)*tx + double(ty)*ty);
+      ux = tx/n; uy = ty/n; uz = 1e0/n;
+    }
+  };
+
+  class ShowerAxisFit  {
+    ShowerAxisConfig    m_cfg;
+    int                 m_maxLayers;
+    int                 m_batch;
+    int                 m_nev = 0;
+    // layer-major batch storage per view: [layer * m_batch + event]
+    std::vector<double> m_pos[2], m_z[2], m_w[2];
+    std::vector<int>    m_nl[2];
+    int                 m_used[2] = { 0, 0 };
+    std::vector<ShowerAxis> m_results;
+    // per event scratch: centroid sums per layer key
+    std::vector<double> m_le, m_lp, m_lz;
+    std::vector<int>    m_lview, m_touched;
+
+    struct ViewFit  {
+      std::vector<double> a, b, va, vb, cab;
+      std::vector<int>    n;
+    };
+
+    void fitView(int view, ViewFit& out) const  {
+      const int B = m_batch, L = m_used[view];
+      const double* P = m_pos[view].data();
+      const double* Z = m_z[view].data();
+      const double* W = m_w[view].data();
+      std::vector<double> R(std::size_t(L)*B, 1e0);
+      std::vector<double> S(B), Sz(B), Szz(B), Sp(B), Szp(B), Sr(B), scale(B);
+      out.a.assign(B, 0e0); out.b.assign(B, 0e0);
+      out.va.assign(B, 0e0); out.vb.assign(B, 0e0); out.cab.assign(B, 0e0);
+      out.n.assign(m_nl[view].begin(), m_nl[view].end());
+      double* a = out.a.data();
+      double* b = out.b.data();
+      for( int it = 0; it <= m_cfg.iterations; ++it )  {
+        std::fill(S.begin(), S.end(), 0e0);   std::fill(Sz.begin(), Sz.end(), 0e0);
+        std::fill(Szz.begin(), Szz.end(), 0e0); std::fill(Sp.begin(), Sp.end(), 0e0);
+        std::fill(Szp.begin(), Szp.end(), 0e0);
+        for( int l = 0; l < L; ++l )  {
+          const std::size_t o = std::size_t(l)*B;
+          for( int e = 0; e < B; ++e )  {
+            const double w  = W[o+e]*R[o+e];
+            const double dz = Z[o+e] - m_cfg.zref;
+            S[e] += w; Sz[e] += w*dz; Szz[e] += w*dz*dz; Sp[e] += w*P[o+e]; Szp[e] += w*dz*P[o+e];
+          }
+        }
+        for( int e = 0; e < B; ++e )  {
+          const double d  = S[e]*Szz[e] - Sz[e]*Sz[e];
+          const double ok = d > 0 ? 1e0 : 0e0;
+          const double dd = d > 0 ? d : 1e0;
+          b[e] = ok * (S[e]*Szp[e] - Sz[e]*Sp[e]) / dd;
+          a[e] = (Sp[e] - b[e]*Sz[e]) / (S[e] > 0 ? S[e] : 1e0);
+          out.vb[e]  = ok * S[e]/dd;
+          out.va[e]  = ok * Szz[e]/dd;
+          out.cab[e] = -ok * Sz[e]/dd;
+        }
+        // residual RMS, then Huber weights for the next iteration
+        std::fill(Sr.begin(), Sr.end(), 0e0);
+        for( int l = 0; l < L; ++l )  {
+          const std::size_t o = std::size_t(l)*B;
+          for( int e = 0; e < B; ++e )  {
+            const double r = P[o+e] - a[e] - b[e]*(Z[o+e] - m_cfg.zref);
+            Sr[e] += W[o+e]*R[o+e]*r*r;
+          }
+        }
+        for( int e = 0; e < B; ++e )
+          scale[e] = std::max(m_cfg.resolution, std::sqrt(Sr[e] / (S[e] > 0 ? S[e] : 1e0)));
+        if ( it == m_cfg.iterations ) break;
+        for( int l = 0; l < L; ++l )  {
+          const std::size_t o = std::size_t(l)*B;
+          for( int e = 0; e < B; ++e )  {
+            const double r = std::abs(P[o+e] - a[e] - b[e]*(Z[o+e] - m_cfg.zref));
+            R[o+e] = r > m_cfg.huberK*scale[e] ? m_cfg.huberK*scale[e]/r : 1e0;
+          }
+        }
+      }
+      // weights are normalised to mean 1: sigma^2 from the residuals with n-2 dof,
+      // not below the centroid resolution
+      const double res2 = m_cfg.resolution*m_cfg.resolution;
+      for( int e = 0; e < B; ++e )  {
+        const int    n  = out.n[e];
+        const double s2 = n > 2 ? std::max(res2, Sr[e]/(n-2)) : res2;
+        out.va[e] *= s2; out.vb[e] *= s2; out.cab[e] *= s2;
+      }
+    }
+
+    void fitBatch()  {
+      if ( m_nev == 0 ) return;
+      ViewFit fx, fy;
+      fitView(AXIS_X, fx);
+      fitView(AXIS_Y, fy);
+      for( int e = 0; e < m_nev; ++e )  {
+        ShowerAxis r;
+        r.tx = float(fx.b[e]); r.x0 = float(fx.a[e]);
+        r.ty = float(fy.b[e]); r.y0 = float(fy.a[e]);
+        r.sigma_tx = float(std::sqrt(fx.vb[e])); r.sigma_x0 = float(std::sqrt(fx.va[e]));
+        r.sigma_ty = float(std::sqrt(fy.vb[e])); r.sigma_y0 = float(std::sqrt(fy.va[e]));
+        r.cov_x = float(fx.cab[e]); r.cov_y = float(fy.cab[e]);
+        r.nx = fx.n[e]; r.ny = fy.n[e];
+        r.status = (r.nx < 2 ? 1 : 0) | (r.ny < 2 ? 2 : 0);
+        m_results.push_back(r);
+      }
+      for( int v = 0; v < 2; ++v )  {
+        std::fill(m_w[v].begin(), m_w[v].end(), 0e0);
+        std::fill(m_nl[v].begin(), m_nl[v].end(), 0);
+        m_used[v] = 0;
+      }
+      m_nev = 0;
+    }
+
+  public:
+    ShowerAxisFit(int maxLayers, const ShowerAxisConfig& cfg = ShowerAxisConfig(), int batch = 1024)
+      : m_cfg(cfg), m_maxLayers(maxLayers), m_batch(batch)  {
+      for( int v = 0; v < 2; ++v )  {
+        m_pos[v].assign(std::size_t(maxLayers)*batch, 0e0);
+        m_z[v].assign(std::size_t(maxLayers)*batch, 0e0);
+        m_w[v].assign(std::size_t(maxLayers)*batch, 0e0);
+        m_nl[v].assign(batch, 0);
+      }
+    }
+
+    /// Accumulate one hit of layer 'key' (dense index < maxLayers) of the current event
+    void addHit(int key, int view, double pos, double z, double e)  {
+      if ( key < 0 || key >= m_maxLayers || view < 0 ) return;
+      if ( m_le.empty() )  {
+        m_le.assign(m_maxLayers, 0e0); m_lp.assign(m_maxLayers, 0e0);
+        m_lz.assign(m_maxLayers, 0e0); m_lview.assign(m_maxLayers, -1);
+      }
+      if ( m_lview[key] < 0 ) m_touched.push_back(key);
+      m_le[key] += e; m_lp[key] += e*pos; m_lz[key] += e*z; m_lview[key] = view;
+    }
+
+    /// Turn the accumulated hits into layer centroids and queue the event for the batch fit
+    void endEvent()  {
+      double esum[2] = { 0e0, 0e0 };
+      for( int k : m_touched )
+        if ( m_le[k] > m_cfg.minEnergy ) esum[m_lview[k]] += m_le[k];
+      for( int k : m_touched )  {
+        const double e = m_le[k];
+        if ( e > m_cfg.minEnergy )  {
+          const int v = m_lview[k];
+          const int l = m_nl[v][m_nev]++;
+          const std::size_t o = std::size_t(l)*m_batch + m_nev;
+          m_pos[v][o] = m_lp[k]/e;
+          m_z[v][o]   = m_lz[k]/e;
+          m_w[v][o]   = e;
+          m_used[v]   = std::max(m_used[v], l+1);
+        }
+        m_le[k] = m_lp[k] = m_lz[k] = 0e0;
+        m_lview[k] = -1;
+      }
+      m_touched.clear();
+      // normalise the weights to mean 1 per view
+      for( int v = 0; v < 2; ++v )  {
+        const int n = m_nl[v][m_nev];
+        for( int l = 0; l < n; ++l )
+          m_w[v][std::size_t(l)*m_batch + m_nev] *= n / esum[v];
+      }
+      if ( ++m_nev == m_batch ) fitBatch();
+    }
+
+    /// Fit the events still queued
+    void flush()  { fitBatch(); }
+
+    /// Results in event order; fitted batch-wise, complete after flush()
+    std::vector<ShowerAxis>& results()  { return m_results; }
+  };
+}
+#endif // DD4SHIP_SHOWERAXISFIT_H
@@ -0,0 +1,78 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Uniform read access to the calorimeter and tracker hits of a G4Event,
+// used by the DD4SHiP event actions.
+//
+//==========================================================================
+#ifndef DD4SHIP_HITACCESS_H
+#define DD4SHIP_HITACCESS_H
+
+#include <DDG4/Geant4Data.h>
+#include <DDG4/Geant4HitCollection.h>
+#include <DD4SHiP/ScintillatorHit.h>
+
+#include <G4Event.hh>
+#include <G4HCofThisEvent.hh>
+
+#include <algorithm>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace dd4ship {
+
+  /// Common view of a calorimeter or tracker hit
+  struct HitView  {
+    unsigned long long                         cellID;
+    double                                     energyDeposit;
+    dd4hep::Position                           position;
+    const dd4hep::sim::Geant4Calorimeter::Hit* calo;   // nullptr for tracker hits
+  };
+
+  /// Call func(collectionName, HitView) for every hit of the event.
+  /// An empty 'collections' list selects every collection.
+  template <typename FUNC>
+  void forEachHit(const G4Event* event, const std::vector<std::string>& collections, FUNC&& func)  {
+    using namespace dd4hep::sim;
+    G4HCofThisEvent* hce = event ? event->GetHCofThisEvent() : nullptr;
+    if ( !hce ) return;
+    for( int ic = 0; ic < hce->GetNumberOfCollections(); ++ic )  {
+      Geant4HitCollection* coll = dynamic_cast<Geant4HitCollection*>(hce->GetHC(ic));
+      if ( !coll ) continue;
+      const std::string name = coll->GetName();
+      if ( !collections.empty() && std::find(collections.begin(), collections.end(), name) == collections.end() )
+        continue;
+      const std::type_info& typ = coll->type().type;
+      if ( typ == typeid(dd4ship::ScintillatorHit) )  {
+        for( std::size_t i = 0; i < coll->GetSize(); ++i )  {
+          dd4ship::ScintillatorHit* h = coll->hit(i);
+          func(name, HitView{ (unsigned long long)h->cellID, h->energyDeposit, h->position, h });
+        }
+      }
+      else if ( typ == typeid(Geant4Calorimeter::Hit) )  {
+        for( std::size_t i = 0; i < coll->GetSize(); ++i )  {
+          Geant4Calorimeter::Hit* h = coll->hit(i);
+          func(name, HitView{ (unsigned long long)h->cellID, h->energyDeposit, h->position, h });
+        }
+      }
+      else if ( typ == typeid(Geant4Tracker::Hit) )  {
+        for( std::size_t i = 0; i < coll->GetSize(); ++i )  {
+          Geant4Tracker::Hit* h = coll->hit(i);
+          func(name, HitView{ (unsigned long long)h->cellID, h->energyDeposit, h->position, nullptr });
+        }
+      }
+    }
+  }
+}
+#endif // DD4SHIP_HITACCESS_H
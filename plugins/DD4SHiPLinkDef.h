@@ -0,0 +1,26 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// ROOT dictionary of the hit classes written by the DD4SHiP sensitive
+// detector actions.
+//
+//==========================================================================
+#ifdef __CLING__
+#pragma link off all globals;
+#pragma link off all classes;
+#pragma link off all functions;
+
+#pragma link C++ namespace dd4ship;
+#pragma link C++ class dd4ship::ScintillatorHit+;
+#pragma link C++ class std::vector<dd4ship::ScintillatorHit*>+;
+#endif
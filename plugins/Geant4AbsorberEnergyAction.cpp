@@ -0,0 +1,249 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Energy deposited in the absorbers per layer, without sensitive detectors.
+//
+//   SIM.action.step = [ {"name": "DD4SHiPAbsorberEnergy/AbsorberEnergy",
+//                        "parameter": {"Output": "absorber_energy.root"}} ]
+//
+// Every placement carrying one of the Fields volIDs (by default
+// splitcal_passivelayer and splitcal_split_layer: the passive_layer lead of
+// code 7 and the split gap of code 8, both numbered by the position in
+// layer_codes) is mapped once to its layer index. A step then costs one
+// lookup of its pre-step volume and adds edep*weight to a fixed array of
+// Layers floats; the absorbers are leaf volumes, so daughters are not
+// searched. At the end of each event the array is filled into the tree
+// ABSORBER (branches "event" and Branch[Layers], in MeV) of Output, one
+// entry per event. For the HCAL add a second instance with Fields
+// ["hcal_passivelayer"] and its own Output.
+//
+// The instances of all threads with the same Output share one tree and
+// fill it under a lock; the last thread out at the end of the run writes
+// it, closes the file (reopened for the next run) and prints the mean
+// energy per layer. In multi-threaded runs the entries are therefore in
+// the order the events finish, not in event order: pair ABSORBER with
+// EVENT through its index on "event", never by entry number:
+//
+//   ABSORBER->BuildIndex("event");
+//   EVENT->SetAlias("event", "Entry$");    // sequential runs: entry = event ID
+//   EVENT->AddFriend(ABSORBER);
+//
+// The alias only holds where EVENT itself is in event order (sequential
+// runs, ddsim); the DDG4 ROOT output stores no event number, so in
+// multi-threaded runs EVENT needs one of its own to be matched.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DD4hep/Volumes.h>
+#include <DDG4/Geant4SteppingAction.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Geant4Mapping.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/ROOTThreads.h>
+#include <DD4SHiP/SharedRunStore.h>
+
+#include <CLHEP/Units/SystemOfUnits.h>
+#include <G4Event.hh>
+#include <G4Step.hh>
+#include <G4Threading.hh>
+#include <G4Track.hh>
+#include <G4VPhysicalVolume.hh>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPAbsorberEnergy : public Geant4SteppingAction  {
+    protected:
+      /// Property: ROOT file of the ABSORBER tree
+      std::string              m_output  { "absorber_energy.root" };
+      /// Property: tree name
+      std::string              m_tree    { "ABSORBER" };
+      /// Property: branch of the per-layer energies
+      std::string              m_branch  { "AbsorberEnergy" };
+      /// Property: volIDs giving the layer index of an absorber, first match wins
+      std::vector<std::string> m_fields  { "splitcal_passivelayer", "splitcal_split_layer" };
+      /// Property: length of the array; deposits in higher layers are only counted
+      int                      m_layers  { 128 };
+
+      // thread local state
+      std::vector<float>       m_energy;
+      const G4VPhysicalVolume* m_lastVol    { nullptr };
+      int                      m_lastLayer  { -1 };
+      long                     m_overflow   { 0 };
+
+      /// Tree and sums shared by the threads writing the same Output
+      struct Shared  {
+        std::unordered_map<const G4VPhysicalVolume*, int> layerOf;
+        std::unique_ptr<TFile>                            file;
+        bool                                              created = false;
+        TTree*                                            tree   = nullptr;
+        int                                               event  = 0;
+        std::vector<float>                                buffer;
+        std::vector<double>                               sums;
+        long                                              events = 0;
+        long                                              overflow = 0;
+      };
+      typedef dd4ship::SharedRunStore<Shared> Store;
+      Store*                   m_store   { nullptr };
+      /// Absorber layers of the shared store, read-only during the run
+      const std::unordered_map<const G4VPhysicalVolume*, int>* m_layerOf { nullptr };
+
+      void openOutput(Shared& s)  {
+        s.file.reset(TFile::Open(m_output.c_str(), s.created ? "UPDATE" : "RECREATE"));
+        if ( !s.file || s.file->IsZombie() ) except("+++ Cannot open %s", m_output.c_str());
+        s.buffer.assign(m_layers, 0.f);
+        s.sums.assign(m_layers, 0e0);
+        s.events = 0;
+        s.tree = s.created ? dynamic_cast<TTree*>(s.file->Get(m_tree.c_str())) : nullptr;
+        if ( s.tree )  {
+          s.tree->SetBranchAddress("event", &s.event);
+          s.tree->SetBranchAddress(m_branch.c_str(), s.buffer.data());
+        }
+        else  {
+          s.tree = new TTree(m_tree.c_str(), "Energy deposited in the absorber layers [MeV]");
+          s.tree->SetDirectory(s.file.get());
+          s.tree->Branch("event", &s.event, "event/I");
+          s.tree->Branch(m_branch.c_str(), s.buffer.data(),
+                         (m_branch + "[" + std::to_string(m_layers) + "]/F").c_str());
+        }
+        s.created = true;
+      }
+
+      /// Layer index of every absorber placement, from the DD4hep volIDs
+      void mapAbsorbers(Shared& s)  {
+        const Geant4GeometryInfo& geo = Geant4Mapping::instance().data();
+        for( const auto& p : geo.g4Placements )  {
+          const PlacedVolume::VolIDs& ids = PlacedVolume(const_cast<TGeoNode*>(p.first)).volIDs();
+          for( const auto& f : m_fields )  {
+            auto id = std::find_if(ids.begin(), ids.end(), [&f](const auto& v) { return v.first == f; });
+            if ( id != ids.end() )  {
+              s.layerOf[p.second] = int(id->second);
+              break;
+            }
+          }
+        }
+        info("+++ %zu absorber placements mapped to layers.", s.layerOf.size());
+      }
+
+    public:
+      DD4SHiPAbsorberEnergy(Geant4Context* ctxt, const std::string& nam)
+        : Geant4SteppingAction(ctxt, nam)  {
+        declareProperty("Output", m_output);
+        declareProperty("Tree",   m_tree);
+        declareProperty("Branch", m_branch);
+        declareProperty("Fields", m_fields);
+        declareProperty("Layers", m_layers);
+        context()->runAction().callAtBegin(this, &DD4SHiPAbsorberEnergy::beginRun);
+        context()->runAction().callAtEnd(this, &DD4SHiPAbsorberEnergy::endRun);
+        context()->eventAction().callAtBegin(this, &DD4SHiPAbsorberEnergy::beginEvent);
+        context()->eventAction().callAtEnd(this, &DD4SHiPAbsorberEnergy::endEvent);
+        dd4ship::enableROOTThreadSafety();
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPAbsorberEnergy()  {
+        InstanceCount::decrement(this);
+      }
+
+      /// The first thread in maps the absorbers and opens the output
+      void beginRun(const G4Run* /* run */)  {
+        if ( m_layers < 1 ) except("+++ Layers must be positive.");
+        m_store = &Store::instance(m_output);
+        m_energy.assign(m_layers, 0.f);
+        m_lastVol  = nullptr;
+        m_overflow = 0;
+        m_store->beginRun([this](Shared& s, bool first)  {
+            m_layerOf = &s.layerOf;
+            if ( !first ) return;
+            if ( s.layerOf.empty() ) mapAbsorbers(s);
+            openOutput(s);
+            if ( G4Threading::IsMultithreadedApplication() )
+              warning("+++ Multi-threaded run: %s entries follow event completion. "
+                      "Match them to EVENT with %s->BuildIndex(\"event\"), not by entry number.",
+                      m_tree.c_str(), m_tree.c_str());
+          });
+      }
+
+      /// The last thread out writes the tree and prints the mean per layer
+      void endRun(const G4Run* /* run */)  {
+        m_store->endRun([this](Shared& s) { s.overflow += m_overflow; },
+                        [this](Shared& s) { writeOutput(s); });
+      }
+
+      /// Write and close the tree, print the mean energy per layer
+      void writeOutput(Shared& s)  {
+        if ( !s.file ) return;
+        s.file->cd();
+        s.tree->Write("", TObject::kOverwrite);
+        s.file->Close();
+        s.file.reset();
+        s.tree = nullptr;
+        double total = 0;
+        for( int l = 0; l < m_layers; ++l )  {
+          if ( s.sums[l] <= 0e0 ) continue;
+          total += s.sums[l];
+          always("+++ Layer %3d: %12.4f MeV/event", l, s.sums[l]/std::max(1L, s.events));
+        }
+        always("+++ %ld events, %.4f MeV/event in the absorbers, written to %s",
+               s.events, total/std::max(1L, s.events), m_output.c_str());
+        if ( s.overflow > 0 )
+          warning("+++ %ld steps in layers >= %d were not stored: increase Layers.", s.overflow, m_layers);
+        s.overflow = 0;
+      }
+
+      void beginEvent(const G4Event* /* event */)  {
+        std::fill(m_energy.begin(), m_energy.end(), 0.f);
+      }
+
+      void endEvent(const G4Event* event)  {
+        m_store->locked([this, event](Shared& s)  {
+            if ( !s.tree ) return;
+            s.event = event->GetEventID();
+            std::copy(m_energy.begin(), m_energy.end(), s.buffer.begin());
+            for( int l = 0; l < m_layers; ++l ) s.sums[l] += m_energy[l];
+            ++s.events;
+            s.tree->Fill();
+          });
+      }
+
+      virtual void operator()(const G4Step* step, G4SteppingManager* /* mgr */) override  {
+        const double edep = step->GetTotalEnergyDeposit();
+        if ( edep <= 0e0 ) return;
+        const G4VPhysicalVolume* vol = step->GetPreStepPoint()->GetPhysicalVolume();
+        if ( vol != m_lastVol )  {
+          const auto& layerOf = *m_layerOf;
+          auto it = layerOf.find(vol);
+          m_lastVol   = vol;
+          m_lastLayer = it == layerOf.end() ? -1 : it->second;
+        }
+        if ( m_lastLayer < 0 ) return;
+        if ( m_lastLayer >= m_layers )  {
+          ++m_overflow;
+          return;
+        }
+        m_energy[m_lastLayer] += float(edep*step->GetTrack()->GetWeight()/CLHEP::MeV);
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPAbsorberEnergy)
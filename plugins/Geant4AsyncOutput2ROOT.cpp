@@ -0,0 +1,372 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// ROOT output with a dedicated writer thread.
+//
+// Writes the same EVENT tree as Geant4Output2ROOT (one branch per
+// calorimeter or tracker hit collection plus MCParticles), but the
+// simulation thread only copies the hits of a finished event into an event
+// buffer; serialisation and compression run on the writer thread while
+// the next event is simulated. QueueDepth buffers can wait for the writer
+// (2: double buffering); the simulation blocks only when all are full.
+// Written buffers come back to the simulation thread, which frees their
+// contents, so hits and particles are only ever touched by one thread.
+// The file is closed at the end of every run and updated by the next one.
+//
+// Enable it in steering.py (DD4SHiPAsyncOutput) or with
+// DD4SHIP_ASYNC_OUTPUT=1. Sequential runs only, and not together with
+// DD4SHiPCheckpoint, which flushes the tree from the simulation thread.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4OutputAction.h>
+#include <DDG4/Geant4HitCollection.h>
+#include <DDG4/Geant4Data.h>
+#include <DDG4/Geant4Particle.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/ScintillatorHit.h>
+#include <DD4SHiP/ROOTThreads.h>
+
+#include <G4Threading.hh>
+
+#include <TFile.h>
+#include <TTree.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPAsyncOutput2ROOT : public Geant4OutputAction  {
+    public:
+      typedef std::vector<Geant4Calorimeter::Hit*> CaloHits;
+      typedef std::vector<Geant4Tracker::Hit*>     TrackerHits;
+      typedef std::vector<dd4ship::ScintillatorHit*> LightHits;
+      typedef std::vector<Geant4Particle*>         Particles;
+
+      /// Everything the writer needs of one event
+      struct EventBuffer  {
+        std::map<std::string, CaloHits>    calo;
+        std::map<std::string, TrackerHits> tracker;
+        std::map<std::string, LightHits>   light;
+        Particles                          particles;
+        bool                               hasParticles = false;
+
+        void clear()  {
+          for( auto& c : calo )    { for( auto* h : c.second ) delete h; c.second.clear(); }
+          for( auto& c : tracker ) { for( auto* h : c.second ) delete h; c.second.clear(); }
+          for( auto& c : light )   { for( auto* h : c.second ) delete h; c.second.clear(); }
+          for( auto* p : particles ) p->release();
+          particles.clear();
+          hasParticles = false;
+        }
+      };
+
+    protected:
+      /// Property: name of the event tree
+      std::string              m_section    { "EVENT" };
+      /// Property: map hit track IDs to MCParticle indices
+      bool                     m_handleMCTruth { true };
+      /// Property: collections not to write
+      std::vector<std::string> m_disabledCollections;
+      /// Property: event buffers waiting for the writer
+      int                      m_depth      { 2 };
+      /// Property: file compression setting (ROOT::RCompressionSetting)
+      int                      m_compression { 101 };
+
+      std::unique_ptr<TFile>   m_file;
+      TTree*                   m_tree       { nullptr };
+      std::thread              m_writer;
+      std::mutex               m_lock;
+      std::condition_variable  m_cond;
+      std::deque<EventBuffer*> m_pending;     // filled, waiting for the writer
+      std::deque<EventBuffer*> m_free;        // written, to be cleared and reused
+      std::vector<std::unique_ptr<EventBuffer> > m_buffers;
+      EventBuffer*             m_current    { nullptr };
+      bool                     m_writing    { false };
+      bool                     m_stop       { false };
+      bool                     m_reopen     { false };
+      Geant4ParticleMap*       m_truth      { nullptr };
+
+      // writer thread state: branch addresses
+      std::map<std::string, CaloHits*>    m_caloAddr;
+      std::map<std::string, TrackerHits*> m_trackerAddr;
+      std::map<std::string, LightHits*>   m_lightAddr;
+      Particles*                          m_particleAddr { nullptr };
+      CaloHits                            m_noCalo;
+      TrackerHits                         m_noTracker;
+      LightHits                           m_noLight;
+      Particles                           m_noParticles;
+
+      bool disabled(const std::string& nam) const  {
+        for( const auto& n : m_disabledCollections ) if ( n == nam ) return true;
+        return false;
+      }
+
+      int truthID(int trackID) const  {
+        return m_truth ? m_truth->particleID(trackID, false) : trackID;
+      }
+
+      /// Writer thread: fill the tree from the pending buffers
+      void writeLoop()  {
+        for(;;)  {
+          EventBuffer* buf = nullptr;
+          {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_cond.wait(guard, [this] { return m_stop || !m_pending.empty(); });
+            if ( m_pending.empty() ) return;
+            buf = m_pending.front();
+            m_pending.pop_front();
+            m_writing = true;
+          }
+          fillTree(*buf);
+          {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_free.push_back(buf);
+            m_writing = false;
+          }
+          m_cond.notify_all();
+        }
+      }
+
+      /// Connect a branch address, creating the branch unless the tree of a previous run has it
+      template <typename T> void attach(const std::string& nam, T** addr)  {
+        if ( m_tree->GetBranch(nam.c_str()) )
+          m_tree->SetBranchAddress(nam.c_str(), addr);
+        else
+          m_tree->Branch(nam.c_str(), addr);
+      }
+
+      void fillTree(EventBuffer& buf)  {
+        for( auto& c : buf.calo )
+          if ( !m_caloAddr.count(c.first) )  {
+            m_caloAddr[c.first] = &m_noCalo;
+            attach(c.first, &m_caloAddr[c.first]);
+          }
+        for( auto& c : buf.tracker )
+          if ( !m_trackerAddr.count(c.first) )  {
+            m_trackerAddr[c.first] = &m_noTracker;
+            attach(c.first, &m_trackerAddr[c.first]);
+          }
+        for( auto& c : buf.light )
+          if ( !m_lightAddr.count(c.first) )  {
+            m_lightAddr[c.first] = &m_noLight;
+            attach(c.first, &m_lightAddr[c.first]);
+          }
+        if ( buf.hasParticles && !m_particleAddr )  {
+          m_particleAddr = &m_noParticles;
+          attach("MCParticles", &m_particleAddr);
+        }
+        for( auto& a : m_caloAddr )  {
+          auto it = buf.calo.find(a.first);
+          a.second = it == buf.calo.end() ? &m_noCalo : &it->second;
+        }
+        for( auto& a : m_trackerAddr )  {
+          auto it = buf.tracker.find(a.first);
+          a.second = it == buf.tracker.end() ? &m_noTracker : &it->second;
+        }
+        for( auto& a : m_lightAddr )  {
+          auto it = buf.light.find(a.first);
+          a.second = it == buf.light.end() ? &m_noLight : &it->second;
+        }
+        if ( m_particleAddr ) m_particleAddr = buf.hasParticles ? &buf.particles : &m_noParticles;
+        m_tree->Fill();
+      }
+
+      /// Wait until the writer has emptied the queue
+      void drain()  {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_cond.wait(guard, [this] { return m_pending.empty() && !m_writing; });
+      }
+
+      /// Open the file: created by the first run, updated by the following ones
+      void openFile()  {
+        if ( m_file ) return;
+        if ( G4Threading::IsMultithreadedApplication() )
+          except("+++ Asynchronous output supports sequential runs only.");
+        m_file.reset(TFile::Open(m_output.c_str(), m_reopen ? "UPDATE" : "RECREATE",
+                                 "DD4hep Simulation data", m_compression));
+        if ( !m_file || m_file->IsZombie() )
+          except("+++ Failed to open ROOT output file %s", m_output.c_str());
+        m_tree = m_reopen ? dynamic_cast<TTree*>(m_file->Get(m_section.c_str())) : nullptr;
+        if ( !m_tree )  {
+          m_tree = new TTree(m_section.c_str(), "Geant4 event information");
+          m_tree->SetDirectory(m_file.get());
+        }
+        m_caloAddr.clear();
+        m_trackerAddr.clear();
+        m_lightAddr.clear();
+        m_particleAddr = nullptr;
+        m_reopen = true;
+        if ( m_buffers.empty() )  {
+          for( int i = 0; i < m_depth + 1; ++i )  {
+            m_buffers.emplace_back(new EventBuffer());
+            m_free.push_back(m_buffers.back().get());
+          }
+          m_writer = std::thread([this] { writeLoop(); });
+          info("+++ Writing %s on a separate thread, %d event buffers.", m_output.c_str(), m_depth);
+        }
+      }
+
+      /// Write the tree and close the file once the writer is idle
+      void closeFile()  {
+        if ( !m_file ) return;
+        drain();
+        {
+          TDirectory::TContext ctx(m_file.get());
+          m_tree->Write("", TObject::kOverwrite);
+        }
+        m_file->Close();
+        m_file.reset();
+        m_tree = nullptr;
+      }
+
+    public:
+      DD4SHiPAsyncOutput2ROOT(Geant4Context* ctxt, const std::string& nam)
+        : Geant4OutputAction(ctxt, nam)  {
+        declareProperty("Section",             m_section);
+        declareProperty("HandleMCTruth",       m_handleMCTruth);
+        declareProperty("DisabledCollections", m_disabledCollections);
+        declareProperty("QueueDepth",          m_depth);
+        declareProperty("Compression",         m_compression);
+        dd4ship::enableROOTThreadSafety();
+        InstanceCount::increment(this);
+      }
+
+      virtual ~DD4SHiPAsyncOutput2ROOT()  {
+        if ( m_writer.joinable() )  {
+          {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_stop = true;
+          }
+          m_cond.notify_all();
+          m_writer.join();
+        }
+        closeFile();
+        for( auto& b : m_buffers ) b->clear();
+        InstanceCount::decrement(this);
+      }
+
+      virtual void beginRun(const G4Run* /* run */) override  {
+        openFile();
+      }
+
+      /// Close the file at every end of run: a crash at teardown does not lose it
+      virtual void endRun(const G4Run* /* run */) override  {
+        closeFile();
+      }
+
+      /// Take a written buffer, free its previous contents
+      virtual void prepare(OutputContext<G4Event>& /* ctxt */) override  {
+        openFile();
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_cond.wait(guard, [this] { return !m_free.empty(); });
+        m_current = m_free.front();
+        m_free.pop_front();
+        guard.unlock();
+        m_current->clear();
+        m_truth = m_handleMCTruth ? context()->event().extension<Geant4ParticleMap>(false) : nullptr;
+      }
+
+      /// Keep the particles alive (extra reference) until the buffer is reused
+      virtual void saveEvent(OutputContext<G4Event>& /* ctxt */) override  {
+        Geant4ParticleMap* parts = context()->event().extension<Geant4ParticleMap>(false);
+        if ( !parts ) return;
+        m_current->hasParticles = true;
+        for( const auto& p : parts->particles() )
+          m_current->particles.push_back(p.second->addRef());
+      }
+
+      /// Copy the hits: the collections are deleted with the G4Event
+      virtual void saveCollection(OutputContext<G4Event>& /* ctxt */, G4VHitsCollection* collection) override  {
+        Geant4HitCollection* coll = dynamic_cast<Geant4HitCollection*>(collection);
+        const std::string nam = collection->GetName();
+        if ( !coll || disabled(nam) ) return;
+        const std::size_t nhits = coll->GetSize();
+        if ( coll->type().type == typeid(Geant4Calorimeter::Hit) )  {
+          CaloHits& out = m_current->calo[nam];
+          out.reserve(nhits);
+          for( std::size_t i = 0; i < nhits; ++i )  {
+            const Geant4Calorimeter::Hit* h = coll->hit(i);
+            auto* c = new Geant4Calorimeter::Hit(h->position);
+            c->cellID        = h->cellID;
+            c->flag          = h->flag;
+            c->g4ID          = h->g4ID;
+            c->energyDeposit = h->energyDeposit;
+            c->truth         = h->truth;
+            for( auto& t : c->truth ) t.trackID = truthID(t.trackID);
+            out.push_back(c);
+          }
+        }
+        else if ( coll->type().type == typeid(Geant4Tracker::Hit) )  {
+          TrackerHits& out = m_current->tracker[nam];
+          out.reserve(nhits);
+          for( std::size_t i = 0; i < nhits; ++i )  {
+            const Geant4Tracker::Hit* h = coll->hit(i);
+            auto* c = new Geant4Tracker::Hit();
+            c->cellID        = h->cellID;
+            c->flag          = h->flag;
+            c->g4ID          = h->g4ID;
+            c->position      = h->position;
+            c->momentum      = h->momentum;
+            c->length        = h->length;
+            c->energyDeposit = h->energyDeposit;
+            c->truth         = h->truth;
+            c->truth.trackID = truthID(c->truth.trackID);
+            out.push_back(c);
+          }
+        }
+        else if ( coll->type().type == typeid(dd4ship::ScintillatorHit) )  {
+          LightHits& out = m_current->light[nam];
+          out.reserve(nhits);
+          for( std::size_t i = 0; i < nhits; ++i )  {
+            const dd4ship::ScintillatorHit* h = coll->hit(i);
+            auto* c = new dd4ship::ScintillatorHit(h->position);
+            c->cellID          = h->cellID;
+            c->flag            = h->flag;
+            c->g4ID            = h->g4ID;
+            c->energyDeposit   = h->energyDeposit;
+            c->visibleEnergy   = h->visibleEnergy;
+            c->photoelectronsA = h->photoelectronsA;
+            c->photoelectronsB = h->photoelectronsB;
+            c->truth           = h->truth;
+            for( auto& t : c->truth ) t.trackID = truthID(t.trackID);
+            out.push_back(c);
+          }
+        }
+        else  {
+          warning("+++ Collection %s has an unsupported hit type: not written.", nam.c_str());
+        }
+      }
+
+      /// Hand the buffer to the writer; block only if QueueDepth buffers are waiting
+      virtual void commit(OutputContext<G4Event>& /* ctxt */) override  {
+        {
+          std::unique_lock<std::mutex> guard(m_lock);
+          m_cond.wait(guard, [this] { return int(m_pending.size()) < m_depth; });
+          m_pending.push_back(m_current);
+        }
+        m_current = nullptr;
+        m_cond.notify_all();
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPAsyncOutput2ROOT)
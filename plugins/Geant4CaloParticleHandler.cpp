@@ -0,0 +1,156 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Calorimeter-aware MC truth reduction for the DDG4 particle handler.
+//
+//   SIM.part.userParticleHandler = "DD4SHiPCaloParticleHandler"
+//
+// Only these particles are kept:
+//  - primaries,
+//  - particles entering a SplitCal/HCAL envelope they were not created in,
+//  - decay products with a kinetic energy above DecayMinEnergy.
+// Every other track, in particular all in-shower secondaries, is dropped
+// when it ends: the particle handler then never creates an MCParticle for
+// it, and its hits are attributed to the closest kept ancestor, i.e. the
+// particle that entered the calorimeter.
+//
+// Envelopes are the placement volumes of the named detectors
+// (include/DD4SHiP/EnvelopeVolume.h). The envelope a track is in is
+// decided from the touchable history (the outermost mother level being an
+// envelope volume). It is looked up at the start of the track and on every
+// step whose touchable differs from the previous one, which includes fast
+// simulation steps with no boundary status; a track entering an envelope
+// other than the one it was born in is kept, so particles passing from the
+// SplitCal to the HCAL are kept too. Steps inside one volume cost a
+// pointer comparison.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4UserParticleHandler.h>
+#include <DDG4/Geant4Particle.h>
+#include <DDG4/Geant4Mapping.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/EnvelopeVolume.h>
+
+#include <CLHEP/Units/SystemOfUnits.h>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4VTouchable.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VProcess.hh>
+
+#include <algorithm>
+#include <vector>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPCaloParticleHandler : public Geant4UserParticleHandler  {
+    protected:
+      /// Property: names of the envelope volumes (detector names in the compact files)
+      std::vector<std::string> m_envelopeNames { "SplitCalTest_Base_and_wide_bars", "HCAL_module" };
+      /// Property: minimal kinetic energy of kept decay products
+      double                   m_decayMinEnergy { 100*CLHEP::MeV };
+
+      std::vector<const G4LogicalVolume*> m_envelopes;
+      bool                     m_resolved  { false };
+      /// State of the current track: birth envelope and last touchable looked at
+      const G4LogicalVolume*   m_birth      { nullptr };
+      const G4VTouchable*      m_last       { nullptr };
+      bool                     m_entered    { false };
+      /// Tracks seen and kept in the current event
+      long                     m_tracks { 0 }, m_kept { 0 };
+
+      void resolveEnvelopes()  {
+        m_resolved = true;
+        for( const auto& env : m_envelopeNames )  {
+          const G4LogicalVolume* lv = dd4ship::envelopeVolume(context()->detectorDescription(),
+                                                              Geant4Mapping::instance().data(), env);
+          if ( lv ) m_envelopes.push_back(lv);
+          else warning("+++ Envelope volume %s not found.", env.c_str());
+        }
+      }
+
+      /// Envelope containing the touchable, nullptr if none
+      const G4LogicalVolume* envelope(const G4VTouchable* touch) const  {
+        if ( !touch ) return nullptr;
+        for( int d = touch->GetHistoryDepth(); d >= 0; --d )  {
+          const G4VPhysicalVolume* pv = touch->GetVolume(d);
+          if ( pv && std::find(m_envelopes.begin(), m_envelopes.end(), pv->GetLogicalVolume()) != m_envelopes.end() )
+            return pv->GetLogicalVolume();
+        }
+        return nullptr;
+      }
+
+    public:
+      DD4SHiPCaloParticleHandler(Geant4Context* ctxt, const std::string& nam)
+        : Geant4UserParticleHandler(ctxt, nam)  {
+        declareProperty("Envelopes",      m_envelopeNames);
+        declareProperty("DecayMinEnergy", m_decayMinEnergy);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPCaloParticleHandler()  {
+        InstanceCount::decrement(this);
+      }
+
+      virtual void begin(const G4Event* /* event */) override  {
+        m_tracks = m_kept = 0;
+      }
+
+      virtual void end(const G4Event* /* event */) override  {
+        debug("+++ Kept %ld of %ld tracks.", m_kept, m_tracks);
+      }
+
+      virtual void begin(const G4Track* track, Particle& /* particle */) override  {
+        if ( !m_resolved ) resolveEnvelopes();
+        m_last    = track->GetTouchable();
+        m_birth   = envelope(m_last);
+        m_entered = false;
+      }
+
+      /// Look for the entry into an envelope other than the birth one
+      virtual void step(const G4Step* step, G4SteppingManager* /* mgr */, Particle& /* particle */) override  {
+        if ( m_entered ) return;
+        const G4VTouchable* touch = step->GetPostStepPoint()->GetTouchable();
+        if ( touch == m_last ) return;
+        m_last = touch;
+        const G4LogicalVolume* env = envelope(touch);
+        if ( env && env != m_birth ) m_entered = true;
+      }
+
+      /// Keep or drop the track; dropped tracks are mapped to their parent
+      virtual void end(const G4Track* track, Particle& particle) override  {
+        PropertyMask mask(particle.reason);
+        const G4VProcess* creator = track->GetCreatorProcess();
+        const bool decay = creator && creator->GetProcessType() == fDecay
+          && track->GetVertexKineticEnergy() > m_decayMinEnergy;
+        ++m_tracks;
+        if ( mask.isSet(G4PARTICLE_PRIMARY) || m_entered || decay )  {
+          mask.set(G4PARTICLE_KEEP_USER);
+          ++m_kept;
+          return;
+        }
+        particle.reason = 0;
+      }
+
+      /// At the end of the event keep exactly the particles selected above
+      virtual bool keepParticle(Particle& particle) override  {
+        return PropertyMask(particle.reason).isSet(G4PARTICLE_KEEP_USER);
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPCaloParticleHandler)
@@ -0,0 +1,205 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Checkpoint and resume for long, sequential ddsim jobs.
+//
+//   SIM.action.event = [ {"name": "DD4SHiPCheckpoint/Checkpoint",
+//                         "parameter": {"Checkpoint": "job.ckpt", "Interval": 100}} ]
+//
+// Before every Interval-th event the output tree is auto-saved (baskets and
+// tree header on disk, so ROOT recovers it after a crash), and only then a
+// record with the event number and the engine state from before that
+// event's primary generation is appended to the Checkpoint log. A record
+// therefore never claims events that are not on disk.
+//
+// To resume, run the same command with a new --outputFile and the parameter
+// "ResumeFile" set to the interrupted output. The latest record not beyond
+// the entries recovered from that file restores the engine; if the file
+// holds more entries than that record (baskets written after the last
+// checkpoint), only its first entries up to the record belong to the
+// result, and this is printed. The job stops after the events still
+// missing. Event IDs continue from the resume event (set at the start of
+// each event, so generator actions still see the job-local number).
+// Input files must be skipped by hand (--skipNEvents <event>, printed at
+// resume); event seeding (random.enableEventSeed) and multi-threaded runs
+// are not supported. Identity of the resumed events with an uninterrupted
+// run follows from the restored engine state but has not been verified bit
+// for bit.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/ROOTThreads.h>
+
+#include <G4Event.hh>
+#include <G4Run.hh>
+#include <G4RunManager.hh>
+#include <G4Threading.hh>
+#include <Randomize.hh>
+
+#include <TROOT.h>
+#include <TFile.h>
+#include <TTree.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unistd.h>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPCheckpoint : public Geant4EventAction  {
+    protected:
+      /// Property: checkpoint log (appended to)
+      std::string m_checkpoint  { "checkpoint.ckpt" };
+      /// Property: events between checkpoints
+      int         m_interval    { 100 };
+      /// Property: output file of the interrupted job; empty: no resume
+      std::string m_resumeFile;
+      /// Property: name of the event tree of the output
+      std::string m_treeName    { "EVENT" };
+
+      /// First event number of this job (0 unless resumed)
+      long        m_offset      { 0 };
+      /// Events done and to be done in this job
+      long        m_done        { 0 };
+      long        m_toProcess   { 0 };
+
+      struct Record  {
+        long        event  = 0;   // next event to simulate
+        long        offset = 0;   // first event of the job that wrote the record
+        std::string engine;
+      };
+
+      std::vector<Record> readLog() const  {
+        std::vector<Record> records;
+        std::ifstream in(m_checkpoint);
+        std::string tag;
+        while( in >> tag )  {
+          Record r;
+          std::size_t len = 0;
+          if ( tag != "checkpoint" || !(in >> r.event >> r.offset >> len) ) break;
+          in.get();
+          r.engine.resize(len);
+          if ( !in.read(&r.engine[0], len) ) break;
+          records.push_back(r);
+        }
+        return records;
+      }
+
+      void appendLog(long event, const std::string& engine)  {
+        FILE* f = std::fopen(m_checkpoint.c_str(), "a");
+        if ( !f )  {
+          error("+++ Cannot append to checkpoint log %s", m_checkpoint.c_str());
+          return;
+        }
+        std::fprintf(f, "checkpoint %ld %ld %zu\n", event, m_offset, engine.size());
+        std::fwrite(engine.data(), 1, engine.size(), f);
+        std::fputc('\n', f);
+        std::fflush(f);
+        ::fsync(::fileno(f));
+        std::fclose(f);
+      }
+
+      /// Auto-save the event tree of every writable file
+      void flushOutput()  {
+        for( TObject* o : *gROOT->GetListOfFiles() )  {
+          TFile* f = dynamic_cast<TFile*>(o);
+          if ( !f || !f->IsWritable() ) continue;
+          if ( TTree* t = dynamic_cast<TTree*>(f->Get(m_treeName.c_str())) )  {
+            t->AutoSave("SaveSelf FlushBaskets");
+            f->Flush();
+          }
+        }
+      }
+
+      void resume()  {
+        std::unique_ptr<TFile> partial(TFile::Open(m_resumeFile.c_str(), "READ"));
+        TTree* tree = partial ? dynamic_cast<TTree*>(partial->Get(m_treeName.c_str())) : nullptr;
+        const long entries = tree ? long(tree->GetEntries()) : 0;
+        const std::vector<Record> records = readLog();
+        // the latest record whose events are all in the interrupted file
+        for( auto r = records.rbegin(); r != records.rend(); ++r )  {
+          const long saved = r->event - r->offset;
+          if ( saved < 0 || saved > entries ) continue;
+          std::istringstream state(r->engine);
+          G4Random::restoreFullState(state);
+          m_offset = r->event;
+          info("+++ Resuming at event %ld (%ld events recovered from %s).",
+               m_offset, saved, m_resumeFile.c_str());
+          if ( saved < entries )
+            warning("+++ %s holds %ld entries after the checkpoint: use only its first %ld entries.",
+                    m_resumeFile.c_str(), entries - saved, saved);
+          info("+++ With input files add --skipNEvents %ld to the original value.", m_offset);
+          return;
+        }
+        except("+++ No checkpoint in %s matches the %ld events of %s.",
+               m_checkpoint.c_str(), entries, m_resumeFile.c_str());
+      }
+
+    public:
+      DD4SHiPCheckpoint(Geant4Context* ctxt, const std::string& nam)
+        : Geant4EventAction(ctxt, nam)  {
+        declareProperty("Checkpoint", m_checkpoint);
+        declareProperty("Interval",   m_interval);
+        declareProperty("ResumeFile", m_resumeFile);
+        declareProperty("Tree",       m_treeName);
+        dd4ship::enableROOTThreadSafety();
+        context()->runAction().callAtBegin(this, &DD4SHiPCheckpoint::beginRun);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPCheckpoint()  {
+        InstanceCount::decrement(this);
+      }
+
+      void beginRun(const G4Run* run)  {
+        if ( G4Threading::IsMultithreadedApplication() )
+          except("+++ Checkpointing needs a sequential run: worker seeds come from the master engine.");
+        // keep the engine state from before primary generation with every event
+        G4RunManager::GetRunManager()->StoreRandomNumberStatusToG4Event(1);
+        m_done = 0;
+        if ( !m_resumeFile.empty() ) resume();
+        m_toProcess = run->GetNumberOfEventToBeProcessed() - m_offset;
+        if ( m_toProcess <= 0 )
+          except("+++ Nothing left to simulate: %s already holds all events.", m_resumeFile.c_str());
+      }
+
+      /// Everything before this event is written: flush, then record the state.
+      /// The first event of a job is recorded too, so that a job interrupted
+      /// before its first flush resumes from its start.
+      virtual void begin(const G4Event* event) override  {
+        const long current = m_offset + m_done;
+        if ( m_offset > 0 ) const_cast<G4Event*>(event)->SetEventID(int(current));
+        if ( m_done == 0 )  {
+          appendLog(current, event->GetRandomNumberStatus());
+          return;
+        }
+        if ( m_interval <= 0 || current % m_interval != 0 ) return;
+        flushOutput();
+        appendLog(current, event->GetRandomNumberStatus());
+      }
+
+      virtual void end(const G4Event* /* event */) override  {
+        if ( ++m_done == m_toProcess && m_offset > 0 )
+          G4RunManager::GetRunManager()->AbortRun(true);
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPCheckpoint)
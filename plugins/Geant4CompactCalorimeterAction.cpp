@@ -0,0 +1,104 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Calorimeter sensitive action with bounded MC truth per hit, for hadron
+// showers in detailed shower mode.
+//
+//   SIM.action.calo = ("DD4SHiPCompactCalorimeterAction",
+//                      {"MaxContributions": 10, "TimeBin": 1*ns})
+//
+// Same hits as Geant4ScintillatorCalorimeterAction (Geant4Calorimeter::Hit,
+// one per cellID), but the step contributions are merged per MC particle
+// and time bin, and only the MaxContributions largest are kept, plus one
+// remainder entry (negative length) holding the rest of the deposit
+// (include/DD4SHiP/ContributionCompaction.h). MaxContributions 0 keeps
+// every step, as the DDG4 action does.
+//
+//==========================================================================
+#include <DDG4/Geant4SensDetAction.inl>
+#include <DDG4/Geant4StepHandler.h>
+#include <DDG4/Geant4Data.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/ContributionCompaction.h>
+
+#include <G4Step.hh>
+
+#include <stdexcept>
+
+namespace dd4hep {
+  namespace sim {
+
+    /// User data of the DD4SHiPCompactCalorimeterAction
+    struct DD4SHiPCompactCalorimeter  {
+      typedef Geant4Calorimeter::Hit Hit;
+      dd4ship::ContributionCompaction compaction;
+    };
+
+    /// Define the compaction properties
+    template <> void Geant4SensitiveAction<DD4SHiPCompactCalorimeter>::initialize()  {
+      declareProperty("MaxContributions", m_userData.compaction.maxContributions);
+      declareProperty("TimeBin",          m_userData.compaction.timeBin);
+    }
+
+    template <> void Geant4SensitiveAction<DD4SHiPCompactCalorimeter>::defineCollections()  {
+      m_collectionID = defineCollection<Geant4Calorimeter::Hit>(m_sensitive.readout().name());
+    }
+
+    /// Add the deposit of a step to the hit of its cell, merging its contribution
+    template <> bool
+    Geant4SensitiveAction<DD4SHiPCompactCalorimeter>::process(const G4Step* step, G4TouchableHistory* /* history */)  {
+      typedef Geant4Calorimeter::Hit Hit;
+      Geant4StepHandler           h(step);
+      Geant4HitData::Contribution contrib = Geant4HitData::extractContribution(step);
+      Geant4HitCollection*        coll    = collection(m_collectionID);
+      VolumeID cell = 0;
+      try  {
+        cell = cellID(step);
+      }
+      catch(const std::runtime_error& e)  {
+        error("+++ %s: step at (%g, %g, %g) without valid cell ID.", e.what(),
+              h.prePos().X(), h.prePos().Y(), h.prePos().Z());
+        return true;
+      }
+      Hit* hit = coll->findByKey<Hit>(cell);
+      if ( !hit )  {
+        DDSegmentation::Vector3D pos = m_segmentation.position(cell);
+        hit = new Hit(h.localToGlobal(pos));
+        hit->cellID = cell;
+        coll->add(cell, hit);
+      }
+      // tracks surviving a Russian roulette (DD4SHiPTrackKiller) carry a weight
+      contrib.deposit    *= h.track->GetWeight();
+      hit->energyDeposit += contrib.deposit;
+      m_userData.compaction.add(hit->truth, contrib);
+      mark(h.track);
+      return true;
+    }
+
+    /// Reduce every hit to MaxContributions entries plus the remainder
+    template <> void Geant4SensitiveAction<DD4SHiPCompactCalorimeter>::end(G4HCofThisEvent* hce)  {
+      if ( m_userData.compaction.enabled() )  {
+        Geant4HitCollection* coll = collection(m_collectionID);
+        for( std::size_t i = 0; i < coll->GetSize(); ++i )  {
+          Geant4Calorimeter::Hit* hit = coll->hit(i);
+          m_userData.compaction.compact(hit->truth);
+        }
+      }
+      Geant4Sensitive::end(hce);
+    }
+  }
+}
+
+using namespace dd4hep::sim;
+typedef Geant4SensitiveAction<DD4SHiPCompactCalorimeter> DD4SHiPCompactCalorimeterAction;
+DECLARE_GEANT4SENSITIVE(DD4SHiPCompactCalorimeterAction)
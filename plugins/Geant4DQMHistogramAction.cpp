@@ -0,0 +1,208 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// In-simulation DQM: fills the readHits_Full.C histograms (h_nrj, h_x, h_y,
+// h_z, h_xz, h_yz) and per-layer energy sums directly from the SD hits.
+//
+//   SIM.action.event = [ {"name": "DD4SHiPDQMHistograms/DQM",
+//                         "parameter": {"Output": "dqm.root"}} ]
+//
+// Every worker thread fills its own histograms. They are merged at the end
+// of each run; the last thread to finish writes the merged set, so the file
+// always holds the sum of all completed runs. Combined with a disabled
+// output plugin no hit collections are written at all. Histograms are
+// booked and cloned with no current directory, so they never attach to a
+// file another action has open in the same thread.
+//
+//==========================================================================
+#include <DD4hep/Detector.h>
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Factories.h>
+#include <DDSegmentation/BitFieldCoder.h>
+#include <DD4SHiP/ROOTThreads.h>
+#include <DD4SHiP/SharedRunStore.h>
+#include "DD4SHiPHitAccess.h"
+
+#include <CLHEP/Units/SystemOfUnits.h>
+#include <G4Run.hh>
+
+#include <TFile.h>
+#include <TH1D.h>
+#include <TH2D.h>
+
+#include <map>
+#include <memory>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPDQMHistograms : public Geant4EventAction  {
+    public:
+      typedef std::map<std::string, std::unique_ptr<TH1> > Histograms;
+      typedef DDSegmentation::BitFieldElement              Field;
+
+    protected:
+      /// Property: output ROOT file
+      std::string              m_output      { "dqm.root" };
+      /// Property: collections to histogram (all if empty)
+      std::vector<std::string> m_collections;
+      /// Property: cellID fields holding the layer index, first match wins
+      std::vector<std::string> m_layerFields { "splitcal_layer", "hcal_layer" };
+      /// Property: number of layer bins for the per-layer sums
+      int                      m_maxLayers   { 100 };
+      /// Properties: binning (nbins, min, max [, nbins, min, max]) as in readHits_Full.C
+      std::vector<double>      m_energyBins  { 100, 0, 100 };
+      std::vector<double>      m_xBins       { 100, -1000, 1000 };
+      std::vector<double>      m_yBins       { 100, -1000, 1000 };
+      std::vector<double>      m_zBins       { 2000, -1000, 2500 };
+      std::vector<double>      m_xzBins      { 300, -1000, 1000, 300, -1000, 2500 };
+      std::vector<double>      m_yzBins      { 100, 0, 100, 100, -1000, 1000 };
+
+      /// Histograms of this thread
+      Histograms                               m_histos;
+      /// Layer field per collection (nullptr if the readout has none)
+      std::map<std::string, const Field*>      m_fields;
+      /// Per-event layer sums per collection
+      std::map<std::string, std::vector<double> > m_layerSum;
+
+      /// Merged histograms shared by all threads
+      typedef dd4ship::SharedRunStore<Histograms> Store;
+
+      TH1* book(const std::string& nam, const std::string& title, const std::vector<double>& b)  {
+        auto& h = m_histos[nam];
+        if ( !h )  {
+          TDirectory::TContext ctx(nullptr);
+          if ( b.size() >= 6 )
+            h.reset(new TH2D(nam.c_str(), title.c_str(), int(b[0]), b[1], b[2], int(b[3]), b[4], b[5]));
+          else if ( b.size() >= 3 )
+            h.reset(new TH1D(nam.c_str(), title.c_str(), int(b[0]), b[1], b[2]));
+          else
+            except("+++ Invalid binning for histogram %s", nam.c_str());
+          h->SetDirectory(nullptr);
+        }
+        return h.get();
+      }
+
+      const Field* layerField(const std::string& coll)  {
+        auto it = m_fields.find(coll);
+        if ( it != m_fields.end() ) return it->second;
+        const Field* fld = nullptr;
+        Readout ro = context()->detectorDescription().readout(coll);
+        if ( ro.isValid() )  {
+          for( const auto& f : m_layerFields )  {
+            try  { fld = ro.idSpec().field(f); break; }
+            catch(const std::exception&)  { }
+          }
+        }
+        if ( !fld ) warning("+++ No layer field in readout of %s: no per-layer sums.", coll.c_str());
+        return m_fields[coll] = fld;
+      }
+
+    public:
+      DD4SHiPDQMHistograms(Geant4Context* ctxt, const std::string& nam)
+        : Geant4EventAction(ctxt, nam)  {
+        declareProperty("Output",        m_output);
+        declareProperty("Collections",   m_collections);
+        declareProperty("LayerFields",   m_layerFields);
+        declareProperty("MaxLayers",     m_maxLayers);
+        declareProperty("EnergyBinning", m_energyBins);
+        declareProperty("XBinning",      m_xBins);
+        declareProperty("YBinning",      m_yBins);
+        declareProperty("ZBinning",      m_zBins);
+        declareProperty("XZBinning",     m_xzBins);
+        declareProperty("YZBinning",     m_yzBins);
+        dd4ship::enableROOTThreadSafety();
+        context()->runAction().callAtBegin(this, &DD4SHiPDQMHistograms::beginRun);
+        context()->runAction().callAtEnd(this, &DD4SHiPDQMHistograms::endRun);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPDQMHistograms()  {
+        InstanceCount::decrement(this);
+      }
+
+      void beginRun(const G4Run* /* run */)  {
+        Store::instance(m_output).beginRun();
+      }
+
+      /// Merge this thread's histograms; the last thread out writes the file
+      void endRun(const G4Run* /* run */)  {
+        Store::instance(m_output).endRun([this](Histograms& histos)  {
+            for( auto& h : m_histos )  {
+              auto& merged = histos[h.first];
+              TDirectory::TContext ctx(nullptr);
+              if ( merged ) merged->Add(h.second.get());
+              else merged.reset((TH1*)h.second->Clone());
+              merged->SetDirectory(nullptr);
+              h.second->Reset();
+            }
+          },
+          [this](Histograms& histos)  {
+            TFile out(m_output.c_str(), "RECREATE");
+            if ( out.IsZombie() )  {
+              error("+++ Cannot open DQM output %s", m_output.c_str());
+              return;
+            }
+            for( auto& h : histos ) h.second->Write();
+            out.Close();
+            info("+++ Wrote %ld DQM histograms to %s", long(histos.size()), m_output.c_str());
+          });
+      }
+
+      virtual void end(const G4Event* event) override  {
+        TH1* h_nrj = book("h_nrj", "h_nrj;Energy loss [MeV];#", m_energyBins);
+        TH1* h_x   = book("h_x",   "h_x;X position [mm];#",     m_xBins);
+        TH1* h_y   = book("h_y",   "h_y;Y position [mm];#",     m_yBins);
+        TH1* h_z   = book("h_z",   "h_z;Z position [mm];#",     m_zBins);
+        TH1* h_xz  = book("h_xz",  "h_xz;X [mm];Z [mm]",        m_xzBins);
+        TH1* h_yz  = book("h_yz",  "h_yz;Y [mm];Z [mm]",        m_yzBins);
+        for( auto& l : m_layerSum ) std::fill(l.second.begin(), l.second.end(), 0e0);
+
+        dd4ship::forEachHit(event, m_collections, [&](const std::string& coll, const dd4ship::HitView& hit)  {
+          const double e = hit.energyDeposit/CLHEP::MeV;
+          const double x = hit.position.x()/CLHEP::mm;
+          const double y = hit.position.y()/CLHEP::mm;
+          const double z = hit.position.z()/CLHEP::mm;
+          h_nrj->Fill(e);
+          h_x->Fill(x);
+          h_y->Fill(y);
+          h_z->Fill(z);
+          static_cast<TH2*>(h_xz)->Fill(x, z);
+          static_cast<TH2*>(h_yz)->Fill(y, z);
+          if ( const Field* fld = layerField(coll) )  {
+            const long layer = fld->value(hit.cellID);
+            auto& sums = m_layerSum[coll];
+            if ( sums.empty() ) sums.resize(m_maxLayers, 0e0);
+            if ( layer >= 0 && layer < m_maxLayers ) sums[layer] += e;
+          }
+        });
+
+        for( const auto& l : m_layerSum )  {
+          const std::vector<double> b2 { double(m_maxLayers), -0.5, m_maxLayers-0.5, m_energyBins[0], m_energyBins[1], m_energyBins[2] };
+          const std::vector<double> b1 { double(m_maxLayers), -0.5, m_maxLayers-0.5 };
+          TH1* h_sum  = book("h_layer_edep_"+l.first, "Summed energy per layer "+l.first+";Layer;Energy [MeV]", b1);
+          TH1* h_evt  = book("h_layer_event_edep_"+l.first, "Event energy per layer "+l.first+";Layer;Energy [MeV]", b2);
+          for( int i = 0; i < m_maxLayers; ++i )  {
+            if ( l.second[i] <= 0e0 ) continue;
+            h_sum->Fill(i, l.second[i]);
+            static_cast<TH2*>(h_evt)->Fill(i, l.second[i]);
+          }
+        }
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPDQMHistograms)
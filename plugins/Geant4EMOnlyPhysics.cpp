@@ -0,0 +1,73 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Lightweight physics list for pure EM SplitCal studies (photons, electrons):
+// standard EM physics plus decays, no hadronic models or tables.
+// Selected at run time with  ddsim ... --physics.list DD4SHiP_EM
+// (see the physics section of steering.py).
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4PhysicsList.h>
+#include <DDG4/Factories.h>
+
+#include <G4VModularPhysicsList.hh>
+#include <G4DecayPhysics.hh>
+#include <G4EmExtraPhysics.hh>
+#include <G4EmStandardPhysics.hh>
+#include <G4EmStandardPhysics_option1.hh>
+#include <G4EmStandardPhysics_option2.hh>
+#include <G4EmStandardPhysics_option3.hh>
+#include <G4EmStandardPhysics_option4.hh>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPEMOnlyPhysics : public Geant4PhysicsList  {
+    protected:
+      /// Property: G4EmStandardPhysics option (0 = default of FTFP_BERT, 1-4 = _optionN)
+      int  m_emOption   { 0 };
+      /// Property: add G4EmExtraPhysics (gamma/lepto-nuclear, muon pair production)
+      bool m_extraPhysics { false };
+
+    public:
+      DD4SHiPEMOnlyPhysics(Geant4Context* ctxt, const std::string& nam)
+        : Geant4PhysicsList(ctxt, nam)  {
+        declareProperty("EMOption",     m_emOption);
+        declareProperty("ExtraPhysics", m_extraPhysics);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPEMOnlyPhysics()  {
+        InstanceCount::decrement(this);
+      }
+      virtual void constructPhysics(G4VModularPhysicsList* physics) override  {
+        const int verbose = 0;
+        switch( m_emOption )  {
+        case 1:  physics->RegisterPhysics(new G4EmStandardPhysics_option1(verbose)); break;
+        case 2:  physics->RegisterPhysics(new G4EmStandardPhysics_option2(verbose)); break;
+        case 3:  physics->RegisterPhysics(new G4EmStandardPhysics_option3(verbose)); break;
+        case 4:  physics->RegisterPhysics(new G4EmStandardPhysics_option4(verbose)); break;
+        default: physics->RegisterPhysics(new G4EmStandardPhysics(verbose));         break;
+        }
+        physics->RegisterPhysics(new G4DecayPhysics(verbose));
+        if ( m_extraPhysics ) physics->RegisterPhysics(new G4EmExtraPhysics(verbose));
+        info("+++ EM-only physics: G4EmStandardPhysics option %d + decays%s",
+             m_emOption, m_extraPhysics ? " + G4EmExtraPhysics" : "");
+        Geant4PhysicsList::constructPhysics(physics);
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPEMOnlyPhysics)
@@ -0,0 +1,521 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Opt-in fast transport of high energy muons through the calorimeters.
+//
+// A muon above MinEnergy entering one of the Envelopes is moved on a straight
+// line to the envelope exit. Every crossed sensitive volume receives an
+// ionisation deposit sampled from the Landau distribution (most probable
+// value and width from the material, CLHEP::RandLandau inverse-CDF table);
+// the deposit goes through the normal DDG4 sensitive detector, so hits look
+// like full simulation hits. The muon loses the mean restricted dE/dx of
+// every crossed volume.
+//
+// Catastrophic interactions (muBrems and muPairProd transferring more than
+// CatastrophicFraction of the kinetic energy) are not left out: along the
+// path the distance to the next one is sampled from the cross sections of
+// the crossed materials (G4EmCalculator, cached in log-energy bins). At
+// that point the process's own EM model samples the secondaries, which
+// are handed to full simulation, and the muon continues with the energy
+// they took; its direction is kept. So the catastrophic losses occur at
+// the full simulation rate. Muon-nuclear interactions (a hadronic process
+// with no energy-transfer cut) and multiple scattering are neglected in
+// the fast transport.
+//
+// The decision to transport fast is taken once per track when it enters
+// an envelope and cached by track ID for the rest of the event. The
+// sensitive detectors see the material and cuts couple of the crossed
+// volume, in the step points and in the track, so that Birks saturation
+// uses the scintillator and not the envelope material.
+//
+// Envelopes are the placement volumes of the named detectors
+// (include/DD4SHiP/EnvelopeVolume.h).
+//
+// Components:
+//   DD4SHiPFastMuonModel   : detector construction action creating the
+//                            regions and the G4VFastSimulationModel
+//   DD4SHiPFastMuonPhysics : physics constructor enabling fast simulation
+//                            for mu+ and mu-
+//   DD4SHiPMuonCatastrophicCount : stepping action counting the
+//                            catastrophic muon interactions in the
+//                            envelopes, full and forced by the fast model
+//                            (validation, tests/physics)
+// The first two are set up by the physics hook in steering.py.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4DetectorConstruction.h>
+#include <DDG4/Geant4PhysicsList.h>
+#include <DDG4/Geant4SteppingAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4Mapping.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/SharedRunStore.h>
+#include <DD4SHiP/EnvelopeVolume.h>
+
+#include <G4VFastSimulationModel.hh>
+#include <G4FastSimulationPhysics.hh>
+#include <G4VModularPhysicsList.hh>
+#include <G4EmCalculator.hh>
+#include <G4VEnergyLossProcess.hh>
+#include <G4VEmModel.hh>
+#include <G4ProcessTable.hh>
+#include <G4DynamicParticle.hh>
+#include <G4RegionStore.hh>
+#include <G4Region.hh>
+#include <G4Navigator.hh>
+#include <G4TransportationManager.hh>
+#include <G4TouchableHistory.hh>
+#include <G4VSensitiveDetector.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VProcess.hh>
+#include <G4Step.hh>
+#include <G4Event.hh>
+#include <G4EventManager.hh>
+#include <G4MuonMinus.hh>
+#include <G4MuonPlus.hh>
+#include <G4Threading.hh>
+#include <G4SystemOfUnits.hh>
+#include <G4PhysicalConstants.hh>
+#include <Randomize.hh>
+#include <CLHEP/Random/RandLandau.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace dd4hep {
+  namespace sim {
+
+    /// Parameters shared by the Geant4 model and its DDG4 configuration action
+    struct FastMuonParameters  {
+      double minEnergy            { 5*CLHEP::GeV };
+      double catastrophicFraction { 0.01 };
+      double landauCap            { 30e0 };
+    };
+
+    /// Catastrophic muon processes forced by the fast model
+    static const char* const s_catastrophic[] = { "muBrems", "muPairProd" };
+    static constexpr int     s_nCatastrophic  = 2;
+
+    /// The Geant4 fast simulation model (one per thread and region)
+    class DD4SHiPFastMuonTransport : public G4VFastSimulationModel  {
+      struct Segment  {
+        G4ThreeVector                 start;
+        double                        length;
+        const G4Material*             material;
+        const G4MaterialCutsCouple*   couple;
+        G4VSensitiveDetector*         sd;
+        G4TouchableHandle             touchable;
+      };
+      /// Decision taken when a track enters the envelope
+      struct Decision  {
+        bool                 fast = false;
+        std::vector<Segment> path;
+      };
+      /// Cross sections per volume of the catastrophic processes
+      struct CatXS  {
+        double xs[s_nCatastrophic] = { -1e0, -1e0 };
+        double total() const  { return xs[0] + xs[1]; }
+      };
+      /// Secondary of a forced interaction, created at the end of DoIt
+      struct Secondary  {
+        G4DynamicParticle* particle;
+        G4ThreeVector      position;
+        double             time;
+      };
+      FastMuonParameters               m_par;
+      std::unique_ptr<G4Navigator>     m_navigator;
+      std::unique_ptr<G4Step>          m_step;
+      /// Decisions of the current event by track ID
+      std::unordered_map<int, Decision> m_decisions;
+      int                              m_event      { -1 };
+      G4EmCalculator                   m_calc;
+      /// Catastrophic cross section cache: (particle, material) -> log-energy bins
+      std::map<std::pair<const G4ParticleDefinition*, const G4Material*>, std::vector<CatXS> > m_catXS;
+      /// Energy loss processes of the catastrophic interactions per particle
+      std::map<const G4ParticleDefinition*, std::vector<G4VEnergyLossProcess*> > m_procs;
+      std::vector<Secondary>           m_secondaries;
+
+      static constexpr int    kBins  = 64;
+      static constexpr double kLogE0 = 0e0;    // log(1 GeV)
+      static constexpr double kDLogE = 0.15;   // up to ~15 TeV
+
+      const CatXS& catastrophicXS(const G4ParticleDefinition* part, const G4Material* mat, double ekin)  {
+        auto& tab = m_catXS[std::make_pair(part, mat)];
+        if ( tab.empty() ) tab.resize(kBins);
+        int bin = int((std::log(ekin/GeV) - kLogE0) / kDLogE);
+        bin = std::max(0, std::min(kBins-1, bin));
+        CatXS& xs = tab[bin];
+        if ( xs.xs[0] < 0e0 )  {
+          const double e   = GeV * std::exp(kLogE0 + (bin+0.5)*kDLogE);
+          const double cut = m_par.catastrophicFraction * e;
+          for( int i = 0; i < s_nCatastrophic; ++i )
+            xs.xs[i] = std::max(0e0, m_calc.ComputeCrossSectionPerVolume(e, part, s_catastrophic[i], mat, cut));
+        }
+        return xs;
+      }
+
+      G4VEnergyLossProcess* process(const G4ParticleDefinition* part, int i)  {
+        auto& procs = m_procs[part];
+        if ( procs.empty() )
+          for( int k = 0; k < s_nCatastrophic; ++k )
+            procs.push_back(dynamic_cast<G4VEnergyLossProcess*>(G4ProcessTable::GetProcessTable()
+                                                                ->FindProcess(s_catastrophic[k], part)));
+        return procs[i];
+      }
+
+      /// Force one catastrophic interaction of process i; returns the energy taken by the secondaries
+      double interact(int i, const G4ParticleDefinition* part, const Segment& s, const G4ThreeVector& pos,
+                      const G4ThreeVector& dir, double ekin, double time)  {
+        G4VEnergyLossProcess* proc = process(part, i);
+        if ( !proc || !s.couple ) return 0e0;
+        std::size_t idx = s.couple->GetIndex();
+        G4VEmModel* model = proc->SelectModelForMaterial(ekin, idx);
+        if ( !model ) return 0e0;
+        G4DynamicParticle muon(part, dir, ekin);
+        std::vector<G4DynamicParticle*> secs;
+        model->SampleSecondaries(&secs, s.couple, &muon, m_par.catastrophicFraction*ekin, ekin);
+        double taken = 0e0;
+        for( G4DynamicParticle* dp : secs )  {
+          taken += dp->GetTotalEnergy();
+          m_secondaries.push_back(Secondary { dp, pos, time });
+        }
+        if ( !secs.empty() ) ++forcedInteractions();
+        return std::min(taken, ekin);
+      }
+
+      /// Straight-line path from the current position to the envelope exit
+      void buildPath(const G4FastTrack& fastTrack, std::vector<Segment>& path)  {
+        const G4Track* track = fastTrack.GetPrimaryTrack();
+        path.clear();
+        if ( !m_navigator )  {
+          m_navigator.reset(new G4Navigator());
+          m_navigator->SetWorldVolume(G4TransportationManager::GetTransportationManager()
+                                      ->GetNavigatorForTracking()->GetWorldVolume());
+        }
+        const double  exitDist = fastTrack.GetEnvelopeSolid()->DistanceToOut(fastTrack.GetPrimaryTrackLocalPosition(),
+                                                                             fastTrack.GetPrimaryTrackLocalDirection());
+        G4ThreeVector pos = track->GetPosition();
+        G4ThreeVector dir = track->GetMomentumDirection();
+        G4VPhysicalVolume* pv = m_navigator->LocateGlobalPointAndSetup(pos, &dir, false, false);
+        double travelled = 0e0;
+        while( pv && travelled < exitDist )  {
+          double safety = 0e0;
+          double len = m_navigator->ComputeStep(pos, dir, exitDist - travelled, safety);
+          if ( len == kInfinity || len > exitDist - travelled ) len = exitDist - travelled;
+          G4LogicalVolume* lv = pv->GetLogicalVolume();
+          Segment seg { pos, len, lv->GetMaterial(), lv->GetMaterialCutsCouple(),
+                        lv->GetSensitiveDetector(), G4TouchableHandle() };
+          if ( seg.sd ) seg.touchable = m_navigator->CreateTouchableHistory();
+          path.push_back(seg);
+          travelled += len;
+          pos += len * dir;
+          m_navigator->SetGeometricallyLimitedStep();
+          pv = m_navigator->LocateGlobalPointAndSetup(pos, &dir, true);
+        }
+      }
+
+      /// Landau sampled ionisation loss of a muon crossing 'len' of 'mat'
+      double sampleDeposit(const G4Material* mat, double len, double ekin, double mass)  {
+        const double gamma = 1e0 + ekin/mass;
+        const double beta2 = 1e0 - 1e0/(gamma*gamma);
+        const double bg2   = beta2*gamma*gamma;
+        const double I     = mat->GetIonisation()->GetMeanExcitationEnergy();
+        const double xi    = twopi_mc2_rcl2 * mat->GetElectronDensity() * len / beta2;
+        const double delta = mat->GetIonisation()->DensityCorrection(std::log(bg2)/(2e0*std::log(10e0)));
+        const double mpv   = xi * (std::log(2e0*electron_mass_c2*bg2/I) + std::log(xi/I) + 0.2 - beta2 - delta);
+        double lambda = CLHEP::RandLandau::shoot(G4Random::getTheEngine());
+        if ( lambda > m_par.landauCap ) lambda = m_par.landauCap;
+        return std::max(0e0, mpv + xi*(lambda + 0.22278));
+      }
+
+    public:
+      DD4SHiPFastMuonTransport(const G4String& nam, G4Region* envelope, const FastMuonParameters& par)
+        : G4VFastSimulationModel(nam, envelope), m_par(par), m_step(new G4Step())  {
+      }
+      virtual G4bool IsApplicable(const G4ParticleDefinition& part) override  {
+        return &part == G4MuonMinus::Definition() || &part == G4MuonPlus::Definition();
+      }
+      /// Decide once per track, when it enters the envelope
+      virtual G4bool ModelTrigger(const G4FastTrack& fastTrack) override  {
+        const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+        const int      evtID = event ? event->GetEventID() : -1;
+        if ( evtID != m_event )  {
+          m_decisions.clear();
+          m_event = evtID;
+        }
+        const G4Track* track = fastTrack.GetPrimaryTrack();
+        auto it = m_decisions.find(track->GetTrackID());
+        if ( it != m_decisions.end() ) return it->second.fast;
+
+        Decision& d = m_decisions[track->GetTrackID()];
+        if ( track->GetKineticEnergy() < m_par.minEnergy ) return false;
+        buildPath(fastTrack, d.path);
+        d.fast = !d.path.empty();
+        return d.fast;
+      }
+      /// Catastrophic interactions forced on this thread (read and reset by DD4SHiPMuonCatastrophicCount)
+      static long& forcedInteractions()  {
+        static thread_local long count = 0;
+        return count;
+      }
+
+      /// Transport along the path cached by ModelTrigger
+      virtual void DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep) override  {
+        const G4Track* track = fastTrack.GetPrimaryTrack();
+        Decision& d = m_decisions[track->GetTrackID()];
+        const G4ParticleDefinition* part = track->GetDefinition();
+        const double  mass = part->GetPDGMass();
+        const G4ThreeVector dir = track->GetMomentumDirection();
+        double ekin = track->GetKineticEnergy();
+        double time = track->GetGlobalTime();
+        double edep = 0e0, length = 0e0;
+
+        G4StepPoint* pre  = m_step->GetPreStepPoint();
+        G4StepPoint* post = m_step->GetPostStepPoint();
+        G4Track*     trk  = const_cast<G4Track*>(track);
+        // The track is shown in the crossed sensitive volume while its SD is called
+        const G4TouchableHandle trackTouchable = trk->GetTouchableHandle();
+        m_step->SetTrack(trk);
+        for( const auto& s : d.path )  {
+          // Sub-segments up to the next forced catastrophic interaction
+          double done = 0e0;
+          while( done < s.length && ekin > 0e0 )  {
+            const CatXS& xs   = catastrophicXS(part, s.material, ekin);
+            const double dist = xs.total() > 0e0 ? -std::log(1e0 - G4UniformRand())/xs.total() : kInfinity;
+            const double len  = std::min(dist, s.length - done);
+            const G4ThreeVector start = s.start + done*dir;
+            const double gamma = 1e0 + ekin/mass;
+            const double beta  = std::sqrt(1e0 - 1e0/(gamma*gamma));
+            const double dt    = len / (beta*c_light);
+            const double dE    = std::min(ekin, m_calc.GetDEDX(ekin, part, s.material) * len);
+            if ( s.sd && len > 0e0 )  {
+              const double dep = std::min(ekin, sampleDeposit(s.material, len, ekin, mass));
+              pre->SetPosition(start);
+              pre->SetGlobalTime(time);
+              pre->SetKineticEnergy(ekin);
+              pre->SetMomentumDirection(dir);
+              pre->SetMass(mass);
+              pre->SetMaterial(const_cast<G4Material*>(s.material));
+              pre->SetMaterialCutsCouple(s.couple);
+              pre->SetTouchableHandle(s.touchable);
+              pre->SetSensitiveDetector(s.sd);
+              post->SetPosition(start + len*dir);
+              post->SetGlobalTime(time + dt);
+              post->SetKineticEnergy(ekin - dE);
+              post->SetMomentumDirection(dir);
+              post->SetMass(mass);
+              post->SetMaterial(const_cast<G4Material*>(s.material));
+              post->SetMaterialCutsCouple(s.couple);
+              post->SetTouchableHandle(s.touchable);
+              m_step->SetStepLength(len);
+              m_step->SetTotalEnergyDeposit(dep);
+              trk->SetTouchableHandle(s.touchable);
+              s.sd->Hit(m_step.get());
+              edep += dep;
+            }
+            ekin   -= dE;
+            time   += dt;
+            length += len;
+            done   += len;
+            if ( dist < s.length - (done - len) && ekin > 0e0 )  {
+              // Catastrophic interaction here, process chosen by its share of the cross section
+              const int i = G4UniformRand()*xs.total() < xs.xs[0] ? 0 : 1;
+              ekin -= interact(i, part, s, start + len*dir, dir, ekin, time);
+            }
+          }
+          if ( ekin <= 0e0 ) break;
+        }
+        trk->SetTouchableHandle(trackTouchable);
+        // Transported: do not trigger again for this track
+        d.fast = false;
+        d.path.clear();
+        // Secondaries of the forced interactions go to full simulation
+        if ( !m_secondaries.empty() )  {
+          fastStep.SetNumberOfSecondaryTracks(G4int(m_secondaries.size()));
+          for( const auto& sec : m_secondaries )  {
+            fastStep.CreateSecondaryTrack(*sec.particle, sec.position, sec.time, false);
+            delete sec.particle;
+          }
+          m_secondaries.clear();
+        }
+        fastStep.ProposePrimaryTrackFinalPosition(track->GetPosition() + length*dir);
+        fastStep.ProposePrimaryTrackFinalTime(time);
+        fastStep.ProposePrimaryTrackFinalKineticEnergy(std::max(0e0, ekin));
+        fastStep.ProposePrimaryTrackPathLength(length);
+        fastStep.ProposeTotalEnergyDeposited(edep);
+        if ( ekin <= 0e0 ) fastStep.KillPrimaryTrack();
+      }
+    };
+
+    /// DDG4 action creating regions and fast muon models at construction time
+    class DD4SHiPFastMuonModel : public Geant4DetectorConstruction  {
+    protected:
+      /// Property: names of the envelope volumes (detector names in the compact files)
+      std::vector<std::string> m_envelopes { "SplitCalTest_Base_and_wide_bars", "HCAL_module" };
+      FastMuonParameters       m_par;
+
+    public:
+      DD4SHiPFastMuonModel(Geant4Context* ctxt, const std::string& nam)
+        : Geant4DetectorConstruction(ctxt, nam)  {
+        declareProperty("Envelopes",            m_envelopes);
+        declareProperty("MinEnergy",            m_par.minEnergy);
+        declareProperty("CatastrophicFraction", m_par.catastrophicFraction);
+        declareProperty("LandauCap",            m_par.landauCap);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPFastMuonModel()  {
+        InstanceCount::decrement(this);
+      }
+      static std::string regionName(const std::string& env)  {
+        return "DD4SHiPFastMuon_" + env;
+      }
+      /// Regions are shared: create them once on the master
+      virtual void constructGeo(Geant4DetectorConstructionContext* ctxt) override  {
+        for( const auto& env : m_envelopes )  {
+          G4LogicalVolume* lv = dd4ship::envelopeVolume(ctxt->description, *ctxt->geometry, env);
+          if ( !lv )  {
+            warning("+++ Envelope volume %s not found: no fast muons there.", env.c_str());
+            continue;
+          }
+          G4Region* reg = new G4Region(regionName(env));
+          lv->SetRegion(reg);
+          reg->AddRootLogicalVolume(lv);
+          info("+++ Fast muon region %s on volume %s", reg->GetName().c_str(), env.c_str());
+        }
+      }
+      /// Models are thread local: one per region and thread
+      virtual void constructSensitives(Geant4DetectorConstructionContext* /* ctxt */) override  {
+        for( const auto& env : m_envelopes )  {
+          G4Region* reg = G4RegionStore::GetInstance()->GetRegion(regionName(env), false);
+          if ( reg ) new DD4SHiPFastMuonTransport(name()+"_"+env, reg, m_par);
+        }
+      }
+    };
+
+    /// Physics constructor activating fast simulation for muons
+    class DD4SHiPFastMuonPhysics : public Geant4PhysicsList  {
+    public:
+      DD4SHiPFastMuonPhysics(Geant4Context* ctxt, const std::string& nam)
+        : Geant4PhysicsList(ctxt, nam)  {
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPFastMuonPhysics()  {
+        InstanceCount::decrement(this);
+      }
+      virtual void constructPhysics(G4VModularPhysicsList* physics) override  {
+        G4FastSimulationPhysics* fast = new G4FastSimulationPhysics();
+        fast->ActivateFastSimulation("mu-");
+        fast->ActivateFastSimulation("mu+");
+        physics->RegisterPhysics(fast);
+        Geant4PhysicsList::constructPhysics(physics);
+      }
+    };
+
+    /// Stepping action counting catastrophic muon interactions in the envelopes
+    /**
+     *  Full simulation interactions are muBrems and muPairProd steps whose
+     *  secondaries take more than CatastrophicFraction of the kinetic
+     *  energy; the interactions forced by the fast model are added at the
+     *  end of each event. Used to compare the fast and full rates.
+     */
+    class DD4SHiPMuonCatastrophicCount : public Geant4SteppingAction  {
+    protected:
+      struct Counts  {
+        long full { 0 }, forced { 0 }, events { 0 };
+      };
+      typedef dd4ship::SharedRunStore<Counts> Store;
+      /// Property: names of the envelope volumes (detector names in the compact files)
+      std::vector<std::string>      m_envelopes { "SplitCalTest_Base_and_wide_bars", "HCAL_module" };
+      /// Property: minimal fraction of the kinetic energy taken by the secondaries
+      double                        m_fraction  { 0.01 };
+      std::set<const G4LogicalVolume*> m_volumes;
+      Counts                        m_counts;
+
+      bool inEnvelope(const G4StepPoint* point) const  {
+        const G4VTouchable* touch = point->GetTouchable();
+        for( int i = 0, n = touch->GetHistoryDepth(); i <= n; ++i )  {
+          if ( m_volumes.count(touch->GetVolume(i)->GetLogicalVolume()) ) return true;
+        }
+        return false;
+      }
+
+    public:
+      DD4SHiPMuonCatastrophicCount(Geant4Context* ctxt, const std::string& nam)
+        : Geant4SteppingAction(ctxt, nam)  {
+        declareProperty("Envelopes",            m_envelopes);
+        declareProperty("CatastrophicFraction", m_fraction);
+        context()->runAction().callAtBegin(this,  &DD4SHiPMuonCatastrophicCount::beginRun);
+        context()->runAction().callAtEnd(this,    &DD4SHiPMuonCatastrophicCount::endRun);
+        context()->eventAction().callAtEnd(this,  &DD4SHiPMuonCatastrophicCount::endEvent);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPMuonCatastrophicCount()  {
+        InstanceCount::decrement(this);
+      }
+      void beginRun(const G4Run*)  {
+        m_volumes.clear();
+        for( const auto& env : m_envelopes )  {
+          G4LogicalVolume* lv = dd4ship::envelopeVolume(context()->detectorDescription(),
+                                                        Geant4Mapping::instance().data(), env);
+          if ( lv ) m_volumes.insert(lv);
+          else warning("+++ Envelope volume %s not found.", env.c_str());
+        }
+        m_counts = Counts();
+        DD4SHiPFastMuonTransport::forcedInteractions() = 0;
+        Store::instance().beginRun();
+      }
+      void endEvent(const G4Event*)  {
+        m_counts.forced += DD4SHiPFastMuonTransport::forcedInteractions();
+        DD4SHiPFastMuonTransport::forcedInteractions() = 0;
+        ++m_counts.events;
+      }
+      void endRun(const G4Run*)  {
+        Store::instance().endRun([this](Counts& c)  {
+            c.full   += m_counts.full;
+            c.forced += m_counts.forced;
+            c.events += m_counts.events;
+          },
+          [this](Counts& c)  {
+            always("+++ Catastrophic muon interactions: full %ld forced %ld events %ld",
+                   c.full, c.forced, c.events);
+            c = Counts();
+          });
+      }
+      virtual void operator()(const G4Step* step, G4SteppingManager*) override  {
+        const G4Track* track = step->GetTrack();
+        const G4ParticleDefinition* part = track->GetDefinition();
+        if ( part != G4MuonMinus::Definition() && part != G4MuonPlus::Definition() ) return;
+        const G4VProcess* proc = step->GetPostStepPoint()->GetProcessDefinedStep();
+        if ( !proc ) return;
+        const G4String& pnam = proc->GetProcessName();
+        if ( pnam != s_catastrophic[0] && pnam != s_catastrophic[1] ) return;
+        if ( !inEnvelope(step->GetPreStepPoint()) ) return;
+        double taken = 0e0;
+        if ( const auto* secs = step->GetSecondaryInCurrentStep() )
+          for( const G4Track* sec : *secs ) taken += sec->GetTotalEnergy();
+        if ( taken > m_fraction * step->GetPreStepPoint()->GetKineticEnergy() ) ++m_counts.full;
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPFastMuonModel)
+DECLARE_GEANT4ACTION(DD4SHiPFastMuonPhysics)
+DECLARE_GEANT4ACTION(DD4SHiPMuonCatastrophicCount)
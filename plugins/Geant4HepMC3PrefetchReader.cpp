@@ -0,0 +1,371 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// HepMC3 event reader with a prefetch thread.
+//
+//   gen = GeneratorAction(Kernel(), 'Geant4InputAction/PrefetchHepMC3', True)
+//   gen.Input = 'DD4SHiPHepMC3PrefetchReader|signal.hepmc3.gz'
+//   gen.Parameters = {'QueueDepth': '8'}
+//
+// A background thread reads the events, converts them into Geant4Particle
+// and Geant4Vertex records and keeps up to QueueDepth of them ready; the
+// simulation thread only takes the next one from the queue. Input that
+// ends in .gz, .bz2, .xz or .zst is decompressed by gzip, bzip2, xz or zstd
+// in a child process, everything else is opened with HepMC3::deduce_reader
+// (Asciiv3, HepMC2 ascii, ...).
+//
+// At the end the reader prints the parse time per event (latency moved off
+// the simulation thread), the time the simulation thread still waited on
+// an empty queue, and the hidden fraction 1 - wait/parse. Parameter
+// PrintLatency = 1 prints both times for every event.
+//
+// Same particle conversion as the DDG4 HepMC3 reader: one vertex at the
+// event position, generator status and mother/daughter indices from the
+// HepMC3 vertices, colour flow from the Flow1/Flow2 attributes.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DD4hep/Printout.h>
+#include <DDG4/Geant4InputAction.h>
+#include <DDG4/Geant4Particle.h>
+#include <DDG4/Geant4Vertex.h>
+
+#include <HepMC3/Attribute.h>
+#include <HepMC3/GenEvent.h>
+#include <HepMC3/GenParticle.h>
+#include <HepMC3/GenVertex.h>
+#include <HepMC3/Reader.h>
+#include <HepMC3/ReaderFactory.h>
+
+#include <CLHEP/Units/PhysicalConstants.h>
+#include <CLHEP/Units/SystemOfUnits.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPHepMC3PrefetchReader : public Geant4EventReader  {
+    public:
+      typedef std::chrono::steady_clock Clock;
+
+      /// Converted event, owned by the queue until handed to the input action
+      struct Event  {
+        Vertices               vertices;
+        std::vector<Particle*> particles;
+        double                 parse_ms = 0;
+
+        ~Event()  {
+          for( auto* v : vertices )  delete v;
+          for( auto* p : particles ) p->release();
+        }
+      };
+
+      /// Read end of a decompressor process
+      class PipeBuffer : public std::streambuf  {
+        FILE* m_pipe;
+        char  m_buffer[1<<16];
+      public:
+        explicit PipeBuffer(FILE* pipe) : m_pipe(pipe)  { }
+        ~PipeBuffer()  { if ( m_pipe ) ::pclose(m_pipe); }
+        int close()  {
+          int sc = m_pipe ? ::pclose(m_pipe) : 0;
+          m_pipe = nullptr;
+          return sc;
+        }
+      protected:
+        virtual int_type underflow() override  {
+          if ( gptr() < egptr() ) return traits_type::to_int_type(*gptr());
+          std::size_t n = m_pipe ? std::fread(m_buffer, 1, sizeof(m_buffer), m_pipe) : 0;
+          if ( n == 0 ) return traits_type::eof();
+          setg(m_buffer, m_buffer, m_buffer + n);
+          return traits_type::to_int_type(*gptr());
+        }
+      };
+
+      /// Decompressed input stream, keeps its buffer alive
+      class PipeStream : public std::istream  {
+        PipeBuffer m_buffer;
+      public:
+        explicit PipeStream(FILE* pipe) : std::istream(nullptr), m_buffer(pipe)  { rdbuf(&m_buffer); }
+        int close()  { return m_buffer.close(); }
+      };
+
+    protected:
+      std::string                      m_fileName;
+      /// Parameter: converted events kept ready
+      int                              m_depth        { 8 };
+      /// Parameter: print parse and wait time of every event
+      int                              m_printLatency { 0 };
+      /// Parameter: names of the colour flow attributes
+      std::string                      m_flow1        { "flow1" };
+      std::string                      m_flow2        { "flow2" };
+
+      std::shared_ptr<HepMC3::Reader>  m_reader;
+      std::shared_ptr<PipeStream>      m_pipe;
+      std::thread                      m_thread;
+      std::mutex                       m_lock;
+      std::condition_variable          m_cond;
+      std::deque<std::unique_ptr<Event> > m_queue;
+      int                              m_skip         { 0 };
+      bool                             m_started      { false };
+      bool                             m_eof          { false };
+      bool                             m_stop         { false };
+
+      // latency bookkeeping, simulation thread
+      long                             m_events       { 0 };
+      long                             m_stalls       { 0 };
+      double                           m_parseSum     { 0 };
+      double                           m_waitSum      { 0 };
+
+      static std::string decompressor(const std::string& fname)  {
+        static const std::pair<const char*, const char*> tools[] = {
+          { ".gz", "gzip" }, { ".bz2", "bzip2" }, { ".xz", "xz" }, { ".zst", "zstd" } };
+        for( const auto& t : tools )  {
+          const std::string ext = t.first;
+          if ( fname.size() > ext.size() && fname.compare(fname.size() - ext.size(), ext.size(), ext) == 0 )
+            return t.second;
+        }
+        return "";
+      }
+
+      void open()  {
+        const std::string tool = decompressor(m_fileName);
+        if ( tool.empty() )  {
+          m_reader = HepMC3::deduce_reader(m_fileName);
+        }
+        else  {
+          std::string quoted = "'";
+          for( char c : m_fileName ) quoted += (c == '\'') ? std::string("'\\''") : std::string(1, c);
+          quoted += "'";
+          const std::string cmd = tool + " -dc -- " + quoted + " 2>/dev/null";
+          FILE* pipe = ::popen(cmd.c_str(), "r");
+          if ( !pipe )
+            except("DD4SHiPHepMC3PrefetchReader", "+++ Cannot start %s for %s", tool.c_str(), m_fileName.c_str());
+          m_pipe   = std::make_shared<PipeStream>(pipe);
+          m_reader = HepMC3::deduce_reader(m_pipe);
+        }
+        if ( !m_reader )
+          except("DD4SHiPHepMC3PrefetchReader", "+++ Cannot open HepMC3 input %s", m_fileName.c_str());
+        printout(INFO, "DD4SHiPHepMC3PrefetchReader", "+++ Reading %s%s%s with a queue of %d events",
+                 m_fileName.c_str(), tool.empty() ? "" : " through ", tool.c_str(), m_depth);
+      }
+
+      void start()  {
+        if ( m_started ) return;
+        m_started = true;
+        open();
+        m_thread = std::thread([this] { readLoop(); });
+      }
+
+      /// Prefetch thread: read, convert and queue events until EOF or stop
+      void readLoop()  {
+        if ( m_skip > 0 && !m_reader->skip(m_skip) )  {
+          std::lock_guard<std::mutex> guard(m_lock);
+          m_eof = true;
+          m_cond.notify_all();
+          return;
+        }
+        for(;;)  {
+          {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_cond.wait(guard, [this] { return m_stop || int(m_queue.size()) < m_depth; });
+            if ( m_stop ) return;
+          }
+          const auto t0 = Clock::now();
+          HepMC3::GenEvent genEvent;
+          std::unique_ptr<Event> evt;
+          if ( m_reader->read_event(genEvent) && !m_reader->failed() )  {
+            evt.reset(new Event());
+            convert(genEvent, *evt);
+            evt->parse_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+          }
+          if ( !evt && m_pipe && m_pipe->close() != 0 )
+            printout(ERROR, "DD4SHiPHepMC3PrefetchReader", "+++ Decompression of %s failed", m_fileName.c_str());
+          std::lock_guard<std::mutex> guard(m_lock);
+          if ( !evt )  {
+            m_eof = true;
+            m_cond.notify_all();
+            return;
+          }
+          m_queue.emplace_back(std::move(evt));
+          m_cond.notify_all();
+        }
+      }
+
+      void convert(const HepMC3::GenEvent& genEvent, Event& evt)  const  {
+        const double momUnit = genEvent.momentum_unit() == HepMC3::Units::GEV ? CLHEP::GeV : CLHEP::MeV;
+        const double lenUnit = genEvent.length_unit()   == HepMC3::Units::MM  ? CLHEP::mm  : CLHEP::cm;
+        const auto&  pos     = genEvent.event_pos();
+        const auto&  genParticles = genEvent.particles();
+
+        Geant4Vertex* vtx = new Geant4Vertex();
+        vtx->x    = pos.x()*lenUnit;
+        vtx->y    = pos.y()*lenUnit;
+        vtx->z    = pos.z()*lenUnit;
+        vtx->time = pos.t()*lenUnit/CLHEP::c_light;
+        evt.vertices.emplace_back(vtx);
+
+        std::map<int, int> index;   // HepMC3 particle id -> position
+        for( std::size_t i = 0; i < genParticles.size(); ++i )
+          index[genParticles[i]->id()] = int(i);
+
+        evt.particles.reserve(genParticles.size());
+        for( std::size_t i = 0; i < genParticles.size(); ++i )  {
+          const auto& mcp = genParticles[i];
+          const auto& mom = mcp->momentum();
+          Particle* p = new Particle(int(i));
+          p->pdgID     = mcp->pid();
+          p->psx       = mom.px()*momUnit;
+          p->psy       = mom.py()*momUnit;
+          p->psz       = mom.pz()*momUnit;
+          p->time      = 0;
+          p->mass      = mcp->generated_mass()*momUnit;
+          p->charge    = 0;   // set by Geant4InputAction from the particle table
+          p->process   = nullptr;
+          p->genStatus = mcp->status() & G4PARTICLE_GEN_STATUS_MASK;
+          switch( mcp->status() )  {
+          case 0:  p->status |= G4PARTICLE_GEN_EMPTY;         break;
+          case 1:  p->status |= G4PARTICLE_GEN_STABLE;        break;
+          case 2:  p->status |= G4PARTICLE_GEN_DECAYED;       break;
+          case 3:  p->status |= G4PARTICLE_GEN_DOCUMENTATION; break;
+          case 4:  p->status |= G4PARTICLE_GEN_BEAM;          break;
+          default: p->status |= G4PARTICLE_GEN_OTHER;         break;
+          }
+          if ( auto flow = mcp->attribute<HepMC3::IntAttribute>(m_flow1) ) p->colorFlow[0] = flow->value();
+          if ( auto flow = mcp->attribute<HepMC3::IntAttribute>(m_flow2) ) p->colorFlow[1] = flow->value();
+          if ( const auto& prod = mcp->production_vertex() )  {
+            const auto& v = prod->position();
+            p->vsx  = v.x()*lenUnit;
+            p->vsy  = v.y()*lenUnit;
+            p->vsz  = v.z()*lenUnit;
+            p->time = v.t()*lenUnit/CLHEP::c_light;
+            for( const auto& mother : prod->particles_in() )
+              p->parents.insert(index[mother->id()]);
+          }
+          else  {
+            p->vsx  = vtx->x;
+            p->vsy  = vtx->y;
+            p->vsz  = vtx->z;
+            p->time = vtx->time;
+            vtx->out.insert(int(i));
+          }
+          if ( const auto& end = mcp->end_vertex() )  {
+            const auto& v = end->position();
+            p->vex = v.x()*lenUnit;
+            p->vey = v.y()*lenUnit;
+            p->vez = v.z()*lenUnit;
+            for( const auto& daughter : end->particles_out() )
+              p->daughters.insert(index[daughter->id()]);
+          }
+          else  {
+            p->vex = p->vsx;
+            p->vey = p->vsy;
+            p->vez = p->vsz;
+          }
+          evt.particles.emplace_back(p);
+        }
+      }
+
+      /// Next converted event; blocks only if the prefetch thread is behind
+      std::unique_ptr<Event> next(double& wait_ms)  {
+        const auto t0 = Clock::now();
+        std::unique_lock<std::mutex> guard(m_lock);
+        const bool stalled = m_queue.empty() && !m_eof;
+        m_cond.wait(guard, [this] { return m_eof || !m_queue.empty(); });
+        wait_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if ( stalled ) ++m_stalls;
+        if ( m_queue.empty() ) return nullptr;
+        std::unique_ptr<Event> evt = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_cond.notify_all();
+        return evt;
+      }
+
+    public:
+      DD4SHiPHepMC3PrefetchReader(const std::string& nam)
+        : Geant4EventReader(nam), m_fileName(nam)  {
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPHepMC3PrefetchReader()  {
+        {
+          std::lock_guard<std::mutex> guard(m_lock);
+          m_stop = true;
+        }
+        m_cond.notify_all();
+        if ( m_thread.joinable() ) m_thread.join();
+        m_queue.clear();
+        if ( m_events > 0 )  {
+          const double parse = m_parseSum/m_events;
+          const double wait  = m_waitSum/m_events;
+          printout(ALWAYS, "DD4SHiPHepMC3PrefetchReader",
+                   "+++ %ld events: parse %.3f ms/event off the simulation thread, wait %.3f ms/event, "
+                   "hidden %.1f%%, queue empty %ld times",
+                   m_events, parse, wait, parse > 0 ? 100.*std::max(0e0, 1. - wait/parse) : 100., m_stalls);
+        }
+        InstanceCount::decrement(this);
+      }
+
+      virtual EventReaderStatus setParameters(std::map<std::string, std::string>& parameters) override  {
+        _getParameterValue(parameters, "QueueDepth",   m_depth,        8);
+        _getParameterValue(parameters, "PrintLatency", m_printLatency, 0);
+        _getParameterValue(parameters, "Flow1",        m_flow1,        std::string("flow1"));
+        _getParameterValue(parameters, "Flow2",        m_flow2,        std::string("flow2"));
+        if ( m_depth < 1 ) m_depth = 1;
+        return EVENT_READER_OK;
+      }
+
+      /// Skipping is done by the prefetch thread before its first event
+      virtual EventReaderStatus moveToEvent(int event_number) override  {
+        if ( event_number == m_currEvent ) return EVENT_READER_OK;
+        if ( m_started || event_number < m_currEvent ) return Geant4EventReader::moveToEvent(event_number);
+        m_skip      = event_number - m_currEvent;
+        m_currEvent = event_number;
+        return EVENT_READER_OK;
+      }
+
+      virtual EventReaderStatus readParticles(int /* event_number */,
+                                              Vertices& vertices,
+                                              std::vector<Particle*>& particles) override  {
+        start();
+        double wait_ms = 0;
+        std::unique_ptr<Event> evt = next(wait_ms);
+        if ( !evt ) return EVENT_READER_EOF;
+        ++m_events;
+        ++m_currEvent;
+        m_parseSum += evt->parse_ms;
+        m_waitSum  += wait_ms;
+        if ( m_printLatency )
+          printout(INFO, "DD4SHiPHepMC3PrefetchReader", "+++ Event %d: parse %.3f ms, waited %.3f ms",
+                   m_currEvent - 1, evt->parse_ms, wait_ms);
+        vertices.insert(vertices.end(), evt->vertices.begin(), evt->vertices.end());
+        particles.insert(particles.end(), evt->particles.begin(), evt->particles.end());
+        evt->vertices.clear();
+        evt->particles.clear();
+        return EVENT_READER_OK;
+      }
+    };
+  }
+}
+
+DECLARE_GEANT4_EVENT_READER_NS(dd4hep::sim, DD4SHiPHepMC3PrefetchReader)
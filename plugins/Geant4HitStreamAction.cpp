@@ -0,0 +1,113 @@
+//==========================================================================
+//  AIDA Detector description implementation 
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Event action pushing per-event hit summaries (cellID, edep, position)
+// into a lock-free shared memory ring for live monitoring:
+//
+//   SIM.action.event = [ {"name": "DD4SHiPHitStream/HitStream",
+//                         "parameter": {"SegmentName": "/dd4ship_hits"}} ]
+//   $> root -l 'scripts/monitorHits.C+("/dd4ship_hits")'
+//
+// The simulation never waits for the monitor: if the ring is full the
+// oldest records are overwritten. Events without hits are published as a
+// single marker record, so the monitor counts every event. In
+// multi-threaded runs every worker writes its own segment, named
+// <SegmentName>.t<thread>.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/SharedHitRing.h>
+#include "DD4SHiPHitAccess.h"
+
+#include <G4Threading.hh>
+#include <CLHEP/Units/SystemOfUnits.h>
+
+#include <memory>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPHitStream : public Geant4EventAction  {
+    protected:
+      /// Property: shared memory segment name
+      std::string              m_segmentName   { "/dd4ship_hits" };
+      /// Property: ring capacity in hit records
+      long                     m_capacity      { 1<<20 };
+      /// Property: collections to stream (all if empty)
+      std::vector<std::string> m_collections;
+      /// Property: do not stream hits below this deposit [MeV]
+      double                   m_minDeposit    { 0e0 };
+
+      std::unique_ptr<dd4ship::SharedHitRing> m_ring;
+
+    public:
+      DD4SHiPHitStream(Geant4Context* ctxt, const std::string& nam)
+        : Geant4EventAction(ctxt, nam)  {
+        declareProperty("SegmentName", m_segmentName);
+        declareProperty("Capacity",    m_capacity);
+        declareProperty("Collections", m_collections);
+        declareProperty("MinDeposit",  m_minDeposit);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPHitStream()  {
+        InstanceCount::decrement(this);
+      }
+      virtual void begin(const G4Event* /* event */) override  {
+        if ( m_ring ) return;
+        std::string seg = m_segmentName;
+        if ( G4Threading::IsWorkerThread() )
+          seg += ".t" + std::to_string(G4Threading::G4GetThreadId());
+        m_ring.reset(new dd4ship::SharedHitRing());
+        try  {
+          m_ring->create(seg, m_capacity);
+          info("+++ Streaming hits to shared memory %s (%ld records)", seg.c_str(), long(m_ring->capacity()));
+        }
+        catch(const std::exception& e)  {
+          error("+++ %s -- hit stream disabled.", e.what());
+        }
+      }
+      virtual void end(const G4Event* event) override  {
+        if ( !m_ring || !m_ring->isOpen() ) return;
+        dd4ship::HitRecord rec;
+        bool pending = false;
+        const std::uint32_t evt = event->GetEventID();
+        dd4ship::forEachHit(event, m_collections, [&](const std::string&, const dd4ship::HitView& h)  {
+          if ( h.energyDeposit/CLHEP::MeV < m_minDeposit ) return;
+          if ( pending ) m_ring->push(rec);
+          rec.cellID = h.cellID;
+          rec.event  = evt;
+          rec.edep   = float(h.energyDeposit/CLHEP::MeV);
+          rec.x      = float(h.position.x()/CLHEP::mm);
+          rec.y      = float(h.position.y()/CLHEP::mm);
+          rec.z      = float(h.position.z()/CLHEP::mm);
+          rec.flags  = 0;
+          pending    = true;
+        });
+        if ( !pending )  {
+          // Empty event: publish a marker so that the monitor counts it
+          rec = dd4ship::HitRecord();
+          rec.event = evt;
+          rec.flags = dd4ship::SharedHitRing::EMPTY_EVENT;
+        }
+        rec.flags |= dd4ship::SharedHitRing::LAST_HIT;
+        m_ring->push(rec);
+        m_ring->endEvent();
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPHitStream)
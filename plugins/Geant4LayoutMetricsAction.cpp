@@ -0,0 +1,188 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Resolution and containment metrics per run, one CSV row per run.
+//
+//   SIM.action.event = [ {"name": "DD4SHiPLayoutMetrics/Metrics",
+//                         "parameter": {"Output": "layout_scan.csv", "BeamEnergy": 10*GeV}} ]
+//
+// Used by scripts/layoutScan.py, which changes Label, Collections, Centre
+// and RearLayerStart before every run. Per event the visible energy E of
+// the selected collections is summed; at the end of the run the row holds
+//   events, mean E, rms E, resolution rms/mean (and its error),
+//   sampling fraction mean/BeamEnergy, energy-weighted mean layer,
+//   rear fraction (layers >= RearLayerStart) and lateral leakage
+//   (hits further than LateralRadius from Centre in x-y).
+// Fractions are ratios of the run sums. Threads are merged as in the DQM
+// action; the last thread out appends the row.
+//
+//==========================================================================
+#include <DD4hep/Detector.h>
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Factories.h>
+#include <DDSegmentation/BitFieldCoder.h>
+#include <DD4SHiP/SharedRunStore.h>
+#include "DD4SHiPHitAccess.h"
+
+#include <CLHEP/Units/SystemOfUnits.h>
+#include <G4Run.hh>
+
+#include <cmath>
+#include <fstream>
+#include <map>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPLayoutMetrics : public Geant4EventAction  {
+    public:
+      typedef DDSegmentation::BitFieldElement Field;
+      struct Sums  {
+        long   events = 0;
+        double energy = 0, energy2 = 0;   // MeV, MeV^2
+        double layer  = 0;                // sum of E*layer
+        double rear   = 0, outside = 0;   // MeV
+      };
+
+    protected:
+      /// Property: CSV table, one row appended per run
+      std::string              m_output      { "layout_scan.csv" };
+      /// Property: label of the run (first column)
+      std::string              m_label;
+      /// Property: collections summed (all if empty)
+      std::vector<std::string> m_collections;
+      /// Property: cellID fields holding the layer index, first match wins
+      std::vector<std::string> m_layerFields { "splitcal_layer", "hcal_layer" };
+      /// Property: beam energy for the sampling fraction
+      double                   m_beamEnergy  { 10*CLHEP::GeV };
+      /// Property: first layer index counted as rear (negative: no rear fraction)
+      int                      m_rearStart   { -1 };
+      /// Property: shower axis position (x, y) and radius for the lateral leakage
+      std::vector<double>      m_centre      { 0e0, 0e0 };
+      double                   m_radius      { 100*CLHEP::mm };
+
+      Sums                                 m_sums;
+      std::map<std::string, const Field*>  m_fields;
+
+      typedef dd4ship::SharedRunStore<Sums> Store;
+
+      const Field* layerField(const std::string& coll)  {
+        auto it = m_fields.find(coll);
+        if ( it != m_fields.end() ) return it->second;
+        const Field* fld = nullptr;
+        Readout ro = context()->detectorDescription().readout(coll);
+        if ( ro.isValid() )  {
+          for( const auto& f : m_layerFields )  {
+            try  { fld = ro.idSpec().field(f); break; }
+            catch(const std::exception&)  { }
+          }
+        }
+        if ( !fld ) warning("+++ No layer field in readout of %s: no depth and rear fraction.", coll.c_str());
+        return m_fields[coll] = fld;
+      }
+
+      void writeRow(const Sums& s)  {
+        const double n     = double(s.events);
+        const double mean  = n > 0 ? s.energy/n : 0e0;
+        const double rms   = n > 1 ? std::sqrt(std::max(0e0, (s.energy2 - n*mean*mean)/(n - 1))) : 0e0;
+        const double res   = mean > 0 ? rms/mean : 0e0;
+        const double resErr = n > 1 ? res/std::sqrt(2e0*n) : 0e0;
+        const double eBeam = m_beamEnergy/CLHEP::MeV;
+        std::ifstream exists(m_output);
+        const bool header = !exists.good();
+        exists.close();
+        std::ofstream out(m_output, std::ios::app);
+        if ( !out )  {
+          error("+++ Cannot append to %s", m_output.c_str());
+          return;
+        }
+        if ( header )
+          out << "label,events,beam_MeV,mean_MeV,rms_MeV,resolution,resolution_err,"
+              << "sampling_fraction,mean_layer,rear_fraction,lateral_leakage\n";
+        out << m_label << ',' << s.events << ',' << eBeam << ',' << mean << ',' << rms << ','
+            << res << ',' << resErr << ',' << (eBeam > 0 ? mean/eBeam : 0e0) << ','
+            << (s.energy > 0 ? s.layer/s.energy : 0e0) << ','
+            << (s.energy > 0 && m_rearStart >= 0 ? s.rear/s.energy : 0e0) << ','
+            << (s.energy > 0 ? s.outside/s.energy : 0e0) << '\n';
+        always("+++ %s: %ld events, E = %.2f +- %.2f MeV, resolution %.4f +- %.4f",
+               m_label.c_str(), s.events, mean, rms, res, resErr);
+      }
+
+    public:
+      DD4SHiPLayoutMetrics(Geant4Context* ctxt, const std::string& nam)
+        : Geant4EventAction(ctxt, nam)  {
+        declareProperty("Output",         m_output);
+        declareProperty("Label",          m_label);
+        declareProperty("Collections",    m_collections);
+        declareProperty("LayerFields",    m_layerFields);
+        declareProperty("BeamEnergy",     m_beamEnergy);
+        declareProperty("RearLayerStart", m_rearStart);
+        declareProperty("Centre",         m_centre);
+        declareProperty("LateralRadius",  m_radius);
+        context()->runAction().callAtBegin(this, &DD4SHiPLayoutMetrics::beginRun);
+        context()->runAction().callAtEnd(this, &DD4SHiPLayoutMetrics::endRun);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPLayoutMetrics()  {
+        InstanceCount::decrement(this);
+      }
+
+      void beginRun(const G4Run* /* run */)  {
+        Store::instance().beginRun();
+        m_sums = Sums();
+      }
+
+      /// Merge this thread's sums; the last thread out appends the row
+      void endRun(const G4Run* /* run */)  {
+        Store::instance().endRun([this](Sums& sums)  {
+            sums.events  += m_sums.events;
+            sums.energy  += m_sums.energy;
+            sums.energy2 += m_sums.energy2;
+            sums.layer   += m_sums.layer;
+            sums.rear    += m_sums.rear;
+            sums.outside += m_sums.outside;
+            m_sums = Sums();
+          },
+          [this](Sums& sums) { writeRow(sums); sums = Sums(); });
+      }
+
+      virtual void end(const G4Event* event) override  {
+        const double cx = m_centre.size() > 0 ? m_centre[0] : 0e0;
+        const double cy = m_centre.size() > 1 ? m_centre[1] : 0e0;
+        const double r2 = m_radius*m_radius;
+        double energy = 0;
+        dd4ship::forEachHit(event, m_collections, [&](const std::string& coll, const dd4ship::HitView& hit)  {
+          if ( !hit.calo ) return;
+          const double e  = hit.energyDeposit/CLHEP::MeV;
+          const double dx = hit.position.x() - cx;
+          const double dy = hit.position.y() - cy;
+          energy += e;
+          if ( dx*dx + dy*dy > r2 ) m_sums.outside += e;
+          if ( const Field* fld = layerField(coll) )  {
+            const long layer = fld->value(hit.cellID);
+            m_sums.layer += e*layer;
+            if ( m_rearStart >= 0 && layer >= m_rearStart ) m_sums.rear += e;
+          }
+        });
+        ++m_sums.events;
+        m_sums.energy  += energy;
+        m_sums.energy2 += energy*energy;
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPLayoutMetrics)
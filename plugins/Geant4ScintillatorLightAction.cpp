@@ -0,0 +1,175 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Calorimeter sensitive action with a parametrised light yield for the
+// scintillator bars and HPL fibres.
+//
+//   SIM.action.mapActions['SplitCal'] = ("DD4SHiPScintillatorLightAction",
+//                                        {"AttenuationLength": 3.5*m})
+//
+// Hits are collected like Geant4ScintillatorCalorimeterAction (one hit per
+// cellID with all contributions), as dd4ship::ScintillatorHit with the
+// Birks-saturated visible energy and the expected photoelectrons at both
+// ends of the bar or fibre added up step by step
+// (include/DD4SHiP/ScintillatorLight.h).
+//
+// The position along the bar is the step midpoint in the frame of the
+// sensitive volume, projected on its longest axis. The attenuation table
+// and that axis are set up once per logical volume (bar type) at its first
+// step, so a step costs one transformation and one table lookup more than
+// the plain energy deposit.
+//
+// MaxContributions and TimeBin bound the MC truth per hit as in the
+// DD4SHiPCompactCalorimeterAction.
+//
+//==========================================================================
+#include <DDG4/Geant4SensDetAction.inl>
+#include <DDG4/Geant4StepHandler.h>
+#include <DDG4/Geant4Data.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/ScintillatorHit.h>
+#include <DD4SHiP/ScintillatorLight.h>
+#include <DD4SHiP/ContributionCompaction.h>
+
+#include <G4Step.hh>
+#include <G4VTouchable.hh>
+#include <G4NavigationHistory.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VSolid.hh>
+
+#include <stdexcept>
+#include <unordered_map>
+
+namespace dd4hep {
+  namespace sim {
+
+    /// User data of the DD4SHiPScintillatorLightAction
+    struct DD4SHiPScintillatorLight  {
+      typedef dd4ship::ScintillatorHit Hit;
+
+      /// Long axis and attenuation table of one bar type
+      struct Bar  {
+        int                       axis   = 2;
+        double                    centre = 0;
+        dd4ship::AttenuationTable table;
+      };
+
+      dd4ship::ScintillatorLightConfig config;
+      dd4ship::ContributionCompaction  compaction;
+      std::unordered_map<const G4LogicalVolume*, Bar> bars;
+      const G4LogicalVolume* lastVolume { nullptr };
+      const Bar*             lastBar    { nullptr };
+
+      const Bar& bar(const G4LogicalVolume* lv)  {
+        if ( lv == lastVolume ) return *lastBar;
+        auto it = bars.find(lv);
+        if ( it == bars.end() )  {
+          G4ThreeVector lo, hi;
+          lv->GetSolid()->BoundingLimits(lo, hi);
+          const G4ThreeVector ext = hi - lo;
+          Bar b;
+          b.axis   = ext.x() >= ext.y() && ext.x() >= ext.z() ? 0 : (ext.y() >= ext.z() ? 1 : 2);
+          b.centre = 0.5*(lo[b.axis] + hi[b.axis]);
+          b.table  = dd4ship::AttenuationTable(0.5*ext[b.axis], config);
+          it = bars.emplace(lv, b).first;
+        }
+        lastVolume = lv;
+        lastBar    = &it->second;
+        return it->second;
+      }
+
+      /// Photoelectrons per MeV of visible energy at both ends for the step midpoint
+      void light(const G4Step* step, float& a, float& b)  {
+        const G4StepPoint*  pre   = step->GetPreStepPoint();
+        const G4VTouchable* touch = pre->GetTouchable();
+        const Bar& br = bar(touch->GetVolume()->GetLogicalVolume());
+        const G4ThreeVector mid   = 0.5*(pre->GetPosition() + step->GetPostStepPoint()->GetPosition());
+        const G4ThreeVector local = touch->GetHistory()->GetTopTransform().TransformPoint(mid);
+        br.table.lookup(local[br.axis] - br.centre, a, b);
+      }
+    };
+
+    /// Define the properties of the light model
+    template <> void Geant4SensitiveAction<DD4SHiPScintillatorLight>::initialize()  {
+      dd4ship::ScintillatorLightConfig& cfg = m_userData.config;
+      declareProperty("BirksConstant",          cfg.birksConstant);
+      declareProperty("LightYield",             cfg.lightYield);
+      declareProperty("AttenuationLength",      cfg.attLength);
+      declareProperty("ShortAttenuationLength", cfg.attLengthShort);
+      declareProperty("ShortFraction",          cfg.shortFraction);
+      declareProperty("TableBins",              cfg.bins);
+      declareProperty("MaxContributions",       m_userData.compaction.maxContributions);
+      declareProperty("TimeBin",                m_userData.compaction.timeBin);
+    }
+
+    /// Hits are dd4ship::ScintillatorHit
+    template <> void Geant4SensitiveAction<DD4SHiPScintillatorLight>::defineCollections()  {
+      m_collectionID = defineCollection<dd4ship::ScintillatorHit>(m_sensitive.readout().name());
+    }
+
+    /// Add the deposit, visible energy and photoelectrons of a step to the hit of its cell
+    template <> bool
+    Geant4SensitiveAction<DD4SHiPScintillatorLight>::process(const G4Step* step, G4TouchableHistory* /* history */)  {
+      typedef dd4ship::ScintillatorHit Hit;
+      Geant4StepHandler          h(step);
+      Geant4HitData::Contribution contrib = Geant4HitData::extractContribution(step);
+      Geant4HitCollection*       coll    = collection(m_collectionID);
+      VolumeID cell = 0;
+      try  {
+        cell = cellID(step);
+      }
+      catch(const std::runtime_error& e)  {
+        error("+++ %s: step at (%g, %g, %g) without valid cell ID.", e.what(),
+              h.prePos().X(), h.prePos().Y(), h.prePos().Z());
+        return true;
+      }
+      Hit* hit = coll->findByKey<Hit>(cell);
+      if ( !hit )  {
+        DDSegmentation::Vector3D pos = m_segmentation.position(cell);
+        hit = new Hit(h.localToGlobal(pos));
+        hit->cellID = cell;
+        coll->add(cell, hit);
+      }
+      float a = 0, b = 0;
+      m_userData.light(step, a, b);
+      // Birks on the real step, then the weight of tracks surviving a Russian roulette (DD4SHiPTrackKiller)
+      const double weight  = h.track->GetWeight();
+      const double visible = weight*dd4ship::birksVisibleEnergy(contrib.deposit, h.stepLength(), m_userData.config.birksConstant);
+      contrib.deposit      *= weight;
+      hit->energyDeposit   += contrib.deposit;
+      hit->visibleEnergy   += visible;
+      hit->photoelectronsA += visible*a;
+      hit->photoelectronsB += visible*b;
+      m_userData.compaction.add(hit->truth, contrib);
+      mark(h.track);
+      return true;
+    }
+
+    /// Reduce every hit to MaxContributions entries plus the remainder
+    template <> void Geant4SensitiveAction<DD4SHiPScintillatorLight>::end(G4HCofThisEvent* hce)  {
+      if ( m_userData.compaction.enabled() )  {
+        Geant4HitCollection* coll = collection(m_collectionID);
+        for( std::size_t i = 0; i < coll->GetSize(); ++i )  {
+          dd4ship::ScintillatorHit* hit = coll->hit(i);
+          m_userData.compaction.compact(hit->truth);
+        }
+      }
+      Geant4Sensitive::end(hce);
+    }
+  }
+}
+
+using namespace dd4hep::sim;
+typedef Geant4SensitiveAction<DD4SHiPScintillatorLight> DD4SHiPScintillatorLightAction;
+DECLARE_GEANT4SENSITIVE(DD4SHiPScintillatorLightAction)
@@ -0,0 +1,246 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Step profiler: number of steps and wall time per logical volume
+// (widebar, thinbar, fibre, core, passive_layer, split, ...) and particle.
+//
+//   SIM.action.step = [ {"name": "DD4SHiPStepProfiler/Profiler",
+//                        "parameter": {"Output": "step_profile.csv"}} ]
+//
+// The time of a step is the wall time (steady_clock) since the previous
+// clock reading on this thread, i.e. transport, physics, sensitive
+// detector and user actions of that step, booked to the step's volume.
+// The clock is also read when a track starts (begin of tracking): the gap
+// since the previous track's last step (end of that track, stacking,
+// track setup) is booked to "<track start>", and the first step of the
+// track is timed from there like any other. The clock restarts at every
+// begin of event, so the time between events is not booked.
+//
+// Counters are per thread (one action instance per worker) and keyed by
+// small integer indices cached per G4LogicalVolume / particle pointer, so
+// a step costs two clock reads (one to time the step, one to exclude the
+// profiler's own bookkeeping) and two pointer compares in the common case;
+// every track adds two more clock reads at its start.
+// At the end of each run they are merged; the last thread out prints the
+// sorted report and writes it as CSV.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4SteppingAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Geant4EventAction.h>
+#include <DDG4/Geant4TrackingAction.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/SharedRunStore.h>
+
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4ParticleDefinition.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+
+namespace dd4hep {
+  namespace sim {
+
+    class DD4SHiPStepProfiler : public Geant4SteppingAction  {
+    public:
+      typedef std::chrono::steady_clock Clock;
+      struct Counter  {
+        unsigned long steps = 0;
+        double        time  = 0;   // seconds
+      };
+      typedef std::map<std::pair<std::string, std::string>, Counter> Table;
+
+    protected:
+      /// Property: CSV output of the full table (empty: report only)
+      std::string m_output    { "step_profile.csv" };
+      /// Property: number of rows printed per section of the report
+      int         m_printRows { 25 };
+
+      // thread local state
+      std::unordered_map<const G4LogicalVolume*, int>      m_volIndex;
+      std::unordered_map<const G4ParticleDefinition*, int> m_partIndex;
+      std::vector<std::string> m_volNames, m_partNames;
+      std::vector<Counter>     m_counts;   // volume-major [vol * m_nPartSlots + part]
+      std::size_t              m_nPartSlots { 16 };
+      const G4LogicalVolume*      m_lastVol  { nullptr };
+      const G4ParticleDefinition* m_lastPart { nullptr };
+      int                         m_lastVolIdx { 0 }, m_lastPartIdx { 0 };
+      int                         m_trackStartIdx { -1 };
+      Clock::time_point           m_last;
+      bool                        m_started { false };
+
+      typedef dd4ship::SharedRunStore<Table> Store;
+
+      int volumeIndex(const G4LogicalVolume* lv)  {
+        auto it = m_volIndex.find(lv);
+        if ( it != m_volIndex.end() ) return it->second;
+        const int idx = int(m_volNames.size());
+        m_volNames.push_back(lv ? lv->GetName() : std::string("<outside>"));
+        m_counts.resize(m_volNames.size()*m_nPartSlots);
+        return m_volIndex[lv] = idx;
+      }
+
+      int particleIndex(const G4ParticleDefinition* p)  {
+        auto it = m_partIndex.find(p);
+        if ( it != m_partIndex.end() ) return it->second;
+        const int idx = int(m_partNames.size());
+        m_partNames.push_back(p ? p->GetParticleName() : std::string("<unknown>"));
+        if ( m_partNames.size() > m_nPartSlots )  {
+          // grow the particle dimension, keep the counts
+          const std::size_t n = m_nPartSlots*2;
+          std::vector<Counter> grown(m_volNames.size()*n);
+          for( std::size_t v = 0; v < m_volNames.size(); ++v )
+            std::copy_n(m_counts.begin()+v*m_nPartSlots, m_nPartSlots, grown.begin()+v*n);
+          m_counts.swap(grown);
+          m_nPartSlots = n;
+        }
+        return m_partIndex[p] = idx;
+      }
+
+      void merge(Table& table)  {
+        for( std::size_t v = 0; v < m_volNames.size(); ++v )
+          for( std::size_t p = 0; p < m_partNames.size(); ++p )  {
+            const Counter& c = m_counts[v*m_nPartSlots+p];
+            if ( c.steps == 0 && c.time == 0 ) continue;
+            Counter& t = table[std::make_pair(m_volNames[v], m_partNames[p])];
+            t.steps += c.steps;
+            t.time  += c.time;
+          }
+        std::fill(m_counts.begin(), m_counts.end(), Counter());
+      }
+
+      void printSection(const std::string& title, const std::map<std::string, Counter>& sums, double total)  {
+        std::vector<std::pair<std::string, Counter> > rows(sums.begin(), sums.end());
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.second.time > b.second.time; });
+        always("+++ %-40s %14s %10s %7s %12s", title.c_str(), "steps", "time [s]", "[%]", "us/step");
+        for( std::size_t i = 0; i < rows.size() && int(i) < m_printRows; ++i )  {
+          const Counter& c = rows[i].second;
+          always("+++ %-40s %14lu %10.3f %7.2f %12.3f", rows[i].first.c_str(), c.steps, c.time,
+                 total > 0 ? 100e0*c.time/total : 0e0, c.steps ? 1e6*c.time/c.steps : 0e0);
+        }
+      }
+
+      void report(const Table& table)  {
+        std::map<std::string, Counter> byVolume, byParticle, byBoth;
+        double total = 0;
+        unsigned long steps = 0;
+        for( const auto& e : table )  {
+          const Counter& c = e.second;
+          total += c.time;
+          steps += c.steps;
+          for( Counter* s : { &byVolume[e.first.first], &byParticle[e.first.second],
+                              &byBoth[e.first.first + " / " + e.first.second] } )  {
+            s->steps += c.steps;
+            s->time  += c.time;
+          }
+        }
+        always("+++ Step profile: %lu steps, %.3f s", steps, total);
+        printSection("logical volume", byVolume, total);
+        printSection("particle", byParticle, total);
+        printSection("logical volume / particle", byBoth, total);
+        if ( m_output.empty() ) return;
+        std::ofstream out(m_output);
+        out << "volume,particle,steps,time_s,fraction\n";
+        for( const auto& e : table )
+          out << e.first.first << ',' << e.first.second << ',' << e.second.steps << ','
+              << e.second.time << ',' << (total > 0 ? e.second.time/total : 0e0) << '\n';
+        info("+++ Step profile written to %s", m_output.c_str());
+      }
+
+    public:
+      DD4SHiPStepProfiler(Geant4Context* ctxt, const std::string& nam)
+        : Geant4SteppingAction(ctxt, nam)  {
+        declareProperty("Output",    m_output);
+        declareProperty("PrintRows", m_printRows);
+        context()->runAction().callAtBegin(this, &DD4SHiPStepProfiler::beginRun);
+        context()->runAction().callAtEnd(this, &DD4SHiPStepProfiler::endRun);
+        context()->eventAction().callAtBegin(this, &DD4SHiPStepProfiler::beginEvent);
+        context()->trackingAction().callAtBegin(this, &DD4SHiPStepProfiler::beginTrack);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPStepProfiler()  {
+        InstanceCount::decrement(this);
+      }
+
+      void beginRun(const G4Run* /* run */)  {
+        Store::instance().beginRun();
+        m_started = false;
+      }
+
+      /// Do not book the time between events
+      void beginEvent(const G4Event* /* event */)  {
+        m_started = false;
+      }
+
+      /// Merge this thread's counters; the last thread out prints the report
+      void endRun(const G4Run* /* run */)  {
+        Store::instance().endRun([this](Table& table) { merge(table); },
+                                 [this](Table& table) { report(table); table.clear(); });
+      }
+
+      /// Book the gap before the track's first step to "<track start>"
+      void beginTrack(const G4Track* track)  {
+        const Clock::time_point now = Clock::now();
+        if ( m_started )  {
+          if ( m_trackStartIdx < 0 )  {
+            m_trackStartIdx = int(m_volNames.size());
+            m_volNames.push_back("<track start>");
+            m_counts.resize(m_volNames.size()*m_nPartSlots);
+          }
+          const G4ParticleDefinition* part = track->GetDefinition();
+          if ( part != m_lastPart )  {
+            m_lastPartIdx = particleIndex(part);
+            m_lastPart    = part;
+          }
+          m_counts[std::size_t(m_trackStartIdx)*m_nPartSlots + m_lastPartIdx].time +=
+            std::chrono::duration<double>(now - m_last).count();
+        }
+        m_started = true;
+        m_last = Clock::now();
+      }
+
+      virtual void operator()(const G4Step* step, G4SteppingManager* /* mgr */) override  {
+        const Clock::time_point now = Clock::now();
+        const double dt = m_started ? std::chrono::duration<double>(now - m_last).count() : 0e0;
+        m_started = true;
+        const G4Track* track = step->GetTrack();
+        const G4VPhysicalVolume* pv = step->GetPreStepPoint()->GetPhysicalVolume();
+        const G4LogicalVolume* lv = pv ? pv->GetLogicalVolume() : nullptr;
+        const G4ParticleDefinition* part = track->GetDefinition();
+        if ( lv != m_lastVol )  {
+          m_lastVolIdx = volumeIndex(lv);
+          m_lastVol    = lv;
+        }
+        if ( part != m_lastPart )  {
+          m_lastPartIdx = particleIndex(part);
+          m_lastPart    = part;
+        }
+        const std::size_t o = std::size_t(m_lastVolIdx)*m_nPartSlots + m_lastPartIdx;
+        ++m_counts[o].steps;
+        m_counts[o].time += dt;
+        // exclude the profiler's own bookkeeping from the next step
+        m_last = Clock::now();
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPStepProfiler)
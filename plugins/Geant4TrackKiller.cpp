@@ -0,0 +1,279 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Killing of slow neutrons and late tracks in the HCAL and lead absorbers.
+//
+//   parameter = {"TimeCut": 500*ns, "Thresholds": {"passive_layer": 1*MeV, "split": 1*MeV},
+//                "RouletteEnergy": 10*MeV, "SurvivalProbability": 0.1}
+//   SIM.action.stack = [ {"name": "DD4SHiPTrackKillerStack/TrackKillerStack", "parameter": parameter} ]
+//   SIM.action.step  = [ {"name": "DD4SHiPTrackKiller/TrackKiller",           "parameter": parameter} ]
+//
+// Three independent cuts, each off by default:
+//  - TimeCut: any track with a global time above the cut is killed.
+//  - Thresholds: a track of one of the Particles (PDG codes, default
+//    neutrons) with a kinetic energy below the threshold of its volume is
+//    killed. The keys are logical volume names, matched from the current
+//    volume outwards through the touchable history (the innermost match
+//    wins), or G4Region names; elsewhere DefaultThreshold applies.
+//  - Russian roulette: such a track below RouletteEnergy survives with
+//    SurvivalProbability and its weight is divided by it; otherwise it is
+//    killed. DD4SHiPCompactCalorimeterAction and DD4SHiPScintillatorLightAction
+//    scale the deposits by the track weight; the DDG4 calorimeter actions do
+//    not, so only use roulette together with those.
+//
+// The stacking action applies the cuts when a secondary is created, so the
+// killed track is never transported. The stepping action catches tracks
+// that slow down below a threshold, pass RouletteEnergy or become late
+// during transport; tracks born below RouletteEnergy are only played by the
+// stacking action. The killed tracks and their kinetic energy are counted
+// per cut and printed at the end of the run.
+//
+//==========================================================================
+#include <DD4hep/InstanceCount.h>
+#include <DDG4/Geant4StackingAction.h>
+#include <DDG4/Geant4SteppingAction.h>
+#include <DDG4/Geant4RunAction.h>
+#include <DDG4/Factories.h>
+#include <DD4SHiP/SharedRunStore.h>
+
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4VTouchable.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Region.hh>
+#include <G4ParticleDefinition.hh>
+#include <Randomize.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace dd4hep {
+  namespace sim {
+
+    /// Cuts and counters shared by DD4SHiPTrackKillerStack and DD4SHiPTrackKiller
+    class DD4SHiPTrackKillerCuts  {
+    public:
+      enum Decision { KEEP = -1, KILL_TIME = 0, KILL_ENERGY, KILL_ROULETTE, SURVIVE_ROULETTE, NDECISIONS };
+      struct Counters  {
+        unsigned long tracks[NDECISIONS] = { 0 };
+        double        energy[NDECISIONS] = { 0 };   // kinetic energy [MeV]
+      };
+
+      /// Properties
+      double                        timeCut             { 0 };
+      std::vector<int>              particles           { 2112 };
+      std::map<std::string, double> thresholds;
+      double                        defaultThreshold    { 0 };
+      double                        rouletteEnergy      { 0 };
+      double                        survivalProbability { 1 };
+
+      Counters counters;
+
+    private:
+      /// Threshold per logical volume, NaN if neither its name nor its region is a key
+      std::unordered_map<const G4LogicalVolume*, std::pair<double, double> > m_volumes;
+      const G4ParticleDefinition* m_lastPart     { nullptr };
+      bool                        m_lastSelected { false };
+
+      const std::pair<double, double>& volumeThreshold(const G4LogicalVolume* lv)  {
+        auto it = m_volumes.find(lv);
+        if ( it != m_volumes.end() ) return it->second;
+        std::pair<double, double> thr(NAN, NAN);
+        auto t = thresholds.find(lv->GetName());
+        if ( t != thresholds.end() ) thr.first = t->second;
+        if ( const G4Region* reg = lv->GetRegion() )  {
+          t = thresholds.find(reg->GetName());
+          if ( t != thresholds.end() ) thr.second = t->second;
+        }
+        return m_volumes[lv] = thr;
+      }
+
+    public:
+      template <typename ACTION> void declare(ACTION* action)  {
+        action->declareProperty("TimeCut",             timeCut);
+        action->declareProperty("Particles",           particles);
+        action->declareProperty("Thresholds",          thresholds);
+        action->declareProperty("DefaultThreshold",    defaultThreshold);
+        action->declareProperty("RouletteEnergy",      rouletteEnergy);
+        action->declareProperty("SurvivalProbability", survivalProbability);
+      }
+
+      bool selected(const G4ParticleDefinition* part)  {
+        if ( part != m_lastPart )  {
+          m_lastPart     = part;
+          m_lastSelected = std::find(particles.begin(), particles.end(), part->GetPDGEncoding()) != particles.end();
+        }
+        return m_lastSelected;
+      }
+
+      /// Kinetic energy threshold at the given location
+      double threshold(const G4VTouchable* touch)  {
+        if ( thresholds.empty() || !touch ) return defaultThreshold;
+        const int depth = touch->GetHistoryDepth();
+        double region = NAN;
+        for( int d = 0; d <= depth; ++d )  {
+          const G4VPhysicalVolume* pv = touch->GetVolume(d);
+          if ( !pv ) continue;
+          const std::pair<double, double>& thr = volumeThreshold(pv->GetLogicalVolume());
+          if ( !std::isnan(thr.first) ) return thr.first;
+          if ( d == 0 ) region = thr.second;
+        }
+        return std::isnan(region) ? defaultThreshold : region;
+      }
+
+      /// Apply the cuts. 'roulette' is true where the track enters the roulette range
+      Decision decide(G4Track* track, double ekin, double time, const G4VTouchable* touch, bool roulette)  {
+        Decision d = KEEP;
+        if ( timeCut > 0 && time > timeCut )
+          d = KILL_TIME;
+        else if ( !selected(track->GetDefinition()) )
+          return KEEP;
+        else if ( ekin < threshold(touch) )
+          d = KILL_ENERGY;
+        else if ( roulette && survivalProbability < 1 && ekin < rouletteEnergy )  {
+          if ( G4UniformRand() < survivalProbability )  {
+            track->SetWeight(track->GetWeight()/survivalProbability);
+            d = SURVIVE_ROULETTE;
+          }
+          else  {
+            d = KILL_ROULETTE;
+          }
+        }
+        if ( d != KEEP )  {
+          ++counters.tracks[d];
+          counters.energy[d] += ekin;
+        }
+        return d;
+      }
+
+      /// Counters of all threads, reported by the last one at the end of the run
+      struct Merged  {
+        Counters   stack, step;
+      };
+      typedef dd4ship::SharedRunStore<Merged> Store;
+
+      static void add(Counters& to, Counters& from)  {
+        for( int i = 0; i < NDECISIONS; ++i )  {
+          to.tracks[i] += from.tracks[i];
+          to.energy[i] += from.energy[i];
+        }
+        from = Counters();
+      }
+
+      template <typename ACTION> static void report(ACTION* action, Merged& s)  {
+        static const char* names[NDECISIONS] = { "time cut", "energy threshold", "roulette killed", "roulette survived" };
+        action->always("+++ Track killer %26s %14s %14s %16s", "", "at stacking", "during steps", "Ekin [MeV]");
+        for( int i = 0; i < NDECISIONS; ++i )
+          action->always("+++ Track killer %-26s %14lu %14lu %16.4g", names[i], s.stack.tracks[i], s.step.tracks[i],
+                         s.stack.energy[i] + s.step.energy[i]);
+        s.stack = s.step = Counters();
+      }
+    };
+
+    /// Applies the DD4SHiPTrackKillerCuts to new tracks
+    class DD4SHiPTrackKillerStack : public Geant4StackingAction  {
+    protected:
+      DD4SHiPTrackKillerCuts m_cuts;
+
+    public:
+      DD4SHiPTrackKillerStack(Geant4Context* ctxt, const std::string& nam)
+        : Geant4StackingAction(ctxt, nam)  {
+        m_cuts.declare(this);
+        context()->runAction().callAtBegin(this, &DD4SHiPTrackKillerStack::beginRun);
+        context()->runAction().callAtEnd(this, &DD4SHiPTrackKillerStack::endRun);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPTrackKillerStack()  {
+        InstanceCount::decrement(this);
+      }
+
+      void beginRun(const G4Run* /* run */)  {
+        DD4SHiPTrackKillerCuts::Store::instance().beginRun();
+      }
+
+      void endRun(const G4Run* /* run */)  {
+        DD4SHiPTrackKillerCuts::Store::instance().endRun(
+          [this](DD4SHiPTrackKillerCuts::Merged& s) { DD4SHiPTrackKillerCuts::add(s.stack, m_cuts.counters); },
+          [this](DD4SHiPTrackKillerCuts::Merged& s) { DD4SHiPTrackKillerCuts::report(this, s); });
+      }
+
+      /// Secondaries carry the touchable of the step that created them
+      virtual TrackClassification classifyNewTrack(G4StackManager* /* mgr */, const G4Track* trk) override  {
+        G4Track* track = const_cast<G4Track*>(trk);
+        switch( m_cuts.decide(track, track->GetKineticEnergy(), track->GetGlobalTime(), track->GetTouchable(), true) )  {
+        case DD4SHiPTrackKillerCuts::KILL_TIME:
+        case DD4SHiPTrackKillerCuts::KILL_ENERGY:
+        case DD4SHiPTrackKillerCuts::KILL_ROULETTE:
+          return TrackClassification(fKill);
+        default:
+          return TrackClassification();
+        }
+      }
+    };
+
+    /// Applies the DD4SHiPTrackKillerCuts at the end of every step
+    class DD4SHiPTrackKiller : public Geant4SteppingAction  {
+    protected:
+      DD4SHiPTrackKillerCuts m_cuts;
+
+    public:
+      DD4SHiPTrackKiller(Geant4Context* ctxt, const std::string& nam)
+        : Geant4SteppingAction(ctxt, nam)  {
+        m_cuts.declare(this);
+        context()->runAction().callAtBegin(this, &DD4SHiPTrackKiller::beginRun);
+        context()->runAction().callAtEnd(this, &DD4SHiPTrackKiller::endRun);
+        InstanceCount::increment(this);
+      }
+      virtual ~DD4SHiPTrackKiller()  {
+        InstanceCount::decrement(this);
+      }
+
+      void beginRun(const G4Run* /* run */)  {
+        DD4SHiPTrackKillerCuts::Store::instance().beginRun();
+      }
+
+      void endRun(const G4Run* /* run */)  {
+        DD4SHiPTrackKillerCuts::Store::instance().endRun(
+          [this](DD4SHiPTrackKillerCuts::Merged& s) { DD4SHiPTrackKillerCuts::add(s.step, m_cuts.counters); },
+          [this](DD4SHiPTrackKillerCuts::Merged& s) { DD4SHiPTrackKillerCuts::report(this, s); });
+      }
+
+      /// Roulette is played once per track, on the step crossing RouletteEnergy
+      virtual void operator()(const G4Step* step, G4SteppingManager* /* mgr */) override  {
+        G4Track* track = step->GetTrack();
+        if ( track->GetTrackStatus() != fAlive ) return;
+        const G4StepPoint* pre  = step->GetPreStepPoint();
+        const G4StepPoint* post = step->GetPostStepPoint();
+        const double ekin = post->GetKineticEnergy();
+        const bool roulette = pre->GetKineticEnergy() >= m_cuts.rouletteEnergy;
+        switch( m_cuts.decide(track, ekin, post->GetGlobalTime(), post->GetTouchable(), roulette) )  {
+        case DD4SHiPTrackKillerCuts::KILL_TIME:
+        case DD4SHiPTrackKillerCuts::KILL_ENERGY:
+        case DD4SHiPTrackKillerCuts::KILL_ROULETTE:
+          track->SetTrackStatus(fStopAndKill);
+          break;
+        default:
+          break;
+        }
+      }
+    };
+  }
+}
+
+using namespace dd4hep::sim;
+DECLARE_GEANT4ACTION(DD4SHiPTrackKillerStack)
+DECLARE_GEANT4ACTION(DD4SHiPTrackKiller)
@@ -0,0 +1,404 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Python module dd4ship: hits, cellIDs and cell centres as NumPy arrays.
+//
+//   import dd4ship
+//   f    = dd4ship.HitFile("ship_calo.root")
+//   hits = f.read("SplitCalWideBarHits")            # dict of arrays + "offsets"
+//   dec  = dd4ship.CellIDDecoder.forReadout("SplitCalWideBarHits", "SHiPCalo.xml")
+//   ids  = dec.decode(hits["cellID"])               # dict field -> int64 array
+//   geo  = dd4ship.Geometry(["SHiPCalo.xml"])
+//   xyz  = geo.centres(hits["cellID"])              # (n, 3) bar centres [mm]
+//   bars = geo.cells("SplitCalWideBarHits")         # all bars of a readout
+//   lib  = dd4ship.HitLibrary("background.hlib")
+//   bkg  = lib.hits(17, "SplitCalWideBarHits")      # view of the mapped file
+//
+// HitFile.read() unpacks a hit collection of the EVENT tree into one column
+// per member (cellID, energy, x, y, z [mm], plus the type specific members
+// of tracker and scintillator hits) and an "event" column; offsets[i] is
+// the first hit of entry start+i. The hits are copied once from the ROOT
+// objects into the C++ columns, which are then adopted by NumPy;
+// HitLibrary.hits() returns a structured array on the memory-mapped
+// library itself. Decoding, centre lookups and reading the tree loop in
+// C++ with the GIL released; ROOT thread safety is enabled when the
+// module is imported, and concurrent reads of one HitFile are serialised
+// by its lock. Every Geometry owns its own Detector instance.
+//
+//==========================================================================
+#include <DD4hep/Detector.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Readout.h>
+#include <DD4hep/VolumeManager.h>
+#include <DD4hep/Volumes.h>
+#include <DDRec/CellIDPositionConverter.h>
+#include <DDG4/Geant4Data.h>
+#include <DDSegmentation/BitFieldCoder.h>
+#include <DD4SHiP/CellIDDecoder.h>
+#include <DD4SHiP/HitLibrary.h>
+#include <DD4SHiP/ROOTThreads.h>
+#include <DD4SHiP/ScintillatorHit.h>
+
+#include <TBranchElement.h>
+#include <TClass.h>
+#include <TFile.h>
+#include <TInterpreter.h>
+#include <TSystem.h>
+#include <TTree.h>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+
+PYBIND11_NUMPY_DTYPE(dd4ship::LibraryHit, cellID, energy, time);
+
+namespace {
+
+  /// NumPy array owning a vector: the data is not copied
+  template <typename T> py::array_t<T> adopt(std::vector<T>&& data)  {
+    auto* owned = new std::vector<T>(std::move(data));
+    py::capsule owner(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(owned->size(), owned->data(), owner);
+  }
+
+  /// Columns of one collection over a range of entries
+  struct HitColumns  {
+    std::vector<std::int64_t>  event;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> cellID;
+    std::vector<double>        energy, x, y, z;
+    std::map<std::string, std::vector<double> > extra;
+
+    template <typename HIT> void add(long entry, const HIT* h)  {
+      event.push_back(entry);
+      cellID.push_back(h->cellID);
+      energy.push_back(h->energyDeposit);
+      x.push_back(h->position.X());
+      y.push_back(h->position.Y());
+      z.push_back(h->position.Z());
+    }
+
+    py::dict release()  {
+      py::dict out;
+      out["event"]   = adopt(std::move(event));
+      out["offsets"] = adopt(std::move(offsets));
+      out["cellID"]  = adopt(std::move(cellID));
+      out["energy"]  = adopt(std::move(energy));
+      out["x"]       = adopt(std::move(x));
+      out["y"]       = adopt(std::move(y));
+      out["z"]       = adopt(std::move(z));
+      for( auto& e : extra ) out[py::str(e.first)] = adopt(std::move(e.second));
+      return out;
+    }
+  };
+
+  const char* const CALO_HITS    = "vector<dd4hep::sim::Geant4Calorimeter::Hit*>";
+  const char* const TRACKER_HITS = "vector<dd4hep::sim::Geant4Tracker::Hit*>";
+  const char* const LIGHT_HITS   = "vector<dd4ship::ScintillatorHit*>";
+
+  /// Hit collections of a DD4SHiP output file
+  class HitFile  {
+    std::unique_ptr<TFile> m_file;
+    TTree*                 m_tree = nullptr;
+    /// read() runs without the GIL and changes the branch status and addresses of the tree
+    std::mutex             m_lock;
+
+    static void loadDictionaries()  {
+      static bool loaded = false;
+      if ( loaded ) return;
+      loaded = true;
+      gSystem->Load("libDDG4Plugins");
+      gSystem->Load("libDDG4IO");
+      gSystem->Load("libDD4SHIPG4");
+      for( const char* cl : { CALO_HITS, TRACKER_HITS } )  {
+        TClass* c = TClass::GetClass(cl);
+        if ( !c || !c->HasDictionary() )
+          gInterpreter->GenerateDictionary(cl, "vector;DD4hep/Objects.h;DDG4/Geant4Data.h");
+      }
+    }
+
+    std::string className(const std::string& coll) const  {
+      auto* br = dynamic_cast<TBranchElement*>(m_tree->GetBranch(coll.c_str()));
+      if ( !br ) throw py::key_error("No hit collection " + coll);
+      return br->GetClassName();
+    }
+
+    template <typename HIT, typename FILL>
+    HitColumns loop(const std::string& coll, long start, long stop, FILL fill)  {
+      std::lock_guard<std::mutex> guard(m_lock);
+      HitColumns cols;
+      std::vector<HIT*>* hits = nullptr;
+      m_tree->SetBranchStatus("*", 0);
+      m_tree->SetBranchStatus((coll + "*").c_str(), 1);
+      m_tree->SetBranchAddress(coll.c_str(), &hits);
+      for( long entry = start; entry < stop; ++entry )  {
+        cols.offsets.push_back(cols.cellID.size());
+        m_tree->GetEntry(entry);
+        if ( !hits ) continue;
+        for( const HIT* h : *hits )  {
+          cols.add(entry, h);
+          fill(cols, h);
+        }
+      }
+      cols.offsets.push_back(cols.cellID.size());
+      m_tree->ResetBranchAddresses();
+      m_tree->SetBranchStatus("*", 1);
+      // ROOT allocated the vector and the hits of the last entry; it deletes the hits of the
+      // previous entries itself when reading the next one
+      if ( hits )  {
+        for( HIT* h : *hits ) delete h;
+        delete hits;
+      }
+      return cols;
+    }
+
+  public:
+    HitFile(const std::string& path, const std::string& tree)  {
+      loadDictionaries();
+      m_file.reset(TFile::Open(path.c_str(), "READ"));
+      if ( !m_file || m_file->IsZombie() ) throw std::runtime_error("Cannot open " + path);
+      m_tree = dynamic_cast<TTree*>(m_file->Get(tree.c_str()));
+      if ( !m_tree ) throw std::runtime_error("No tree " + tree + " in " + path);
+    }
+
+    long entries() const  { return long(m_tree->GetEntries()); }
+
+    std::vector<std::string> collections() const  {
+      std::vector<std::string> names;
+      for( TObject* o : *m_tree->GetListOfBranches() )  {
+        auto* br = dynamic_cast<TBranchElement*>(o);
+        const std::string cl = br ? br->GetClassName() : "";
+        if ( cl == CALO_HITS || cl == TRACKER_HITS || cl == LIGHT_HITS ) names.push_back(o->GetName());
+      }
+      return names;
+    }
+
+    py::dict read(const std::string& coll, long start, long stop)  {
+      const std::string cl = className(coll);
+      if ( cl != CALO_HITS && cl != TRACKER_HITS && cl != LIGHT_HITS )
+        throw py::type_error(coll + " is not a hit collection (" + cl + ")");
+      if ( stop < 0 || stop > entries() ) stop = entries();
+      if ( start < 0 ) start = 0;
+      HitColumns cols;
+      {
+        py::gil_scoped_release nogil;
+        typedef dd4hep::sim::Geant4Calorimeter::Hit CaloHit;
+        typedef dd4hep::sim::Geant4Tracker::Hit     TrackerHit;
+        if ( cl == CALO_HITS )  {
+          cols = loop<CaloHit>(coll, start, stop, [](HitColumns&, const CaloHit*) {});
+        }
+        else if ( cl == LIGHT_HITS )  {
+          cols = loop<dd4ship::ScintillatorHit>(coll, start, stop, [](HitColumns& c, const dd4ship::ScintillatorHit* h)  {
+            c.extra["visible"].push_back(h->visibleEnergy);
+            c.extra["photoelectronsA"].push_back(h->photoelectronsA);
+            c.extra["photoelectronsB"].push_back(h->photoelectronsB);
+          });
+        }
+        else  {
+          cols = loop<TrackerHit>(coll, start, stop, [](HitColumns& c, const TrackerHit* h)  {
+            c.extra["px"].push_back(h->momentum.X());
+            c.extra["py"].push_back(h->momentum.Y());
+            c.extra["pz"].push_back(h->momentum.Z());
+            c.extra["length"].push_back(h->length);
+            c.extra["time"].push_back(h->truth.time);
+          });
+        }
+      }
+      return cols.release();
+    }
+  };
+
+  /// Decode an array of cellIDs field by field
+  py::dict decode(const dd4ship::CellIDDecoder& dec, py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> ids)  {
+    py::dict out;
+    for( const auto& f : dec.fields() )  {
+      std::vector<std::int64_t> values(ids.size());
+      {
+        py::gil_scoped_release nogil;
+        const std::uint64_t* in = ids.data();
+        for( std::size_t i = 0, n = values.size(); i < n; ++i ) values[i] = f.value(in[i]);
+      }
+      out[py::str(f.name)] = adopt(std::move(values));
+    }
+    return out;
+  }
+
+  py::array_t<std::int64_t> decodeField(const dd4ship::CellIDDecoder& dec, const std::string& name,
+                                        py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> ids)  {
+    const dd4ship::CellIDField f = dec.field(name);
+    std::vector<std::int64_t> values(ids.size());
+    {
+      py::gil_scoped_release nogil;
+      const std::uint64_t* in = ids.data();
+      for( std::size_t i = 0, n = values.size(); i < n; ++i ) values[i] = f.value(in[i]);
+    }
+    return adopt(std::move(values));
+  }
+
+  /// Centres of bars and fibres from the compact geometry
+  class Geometry  {
+    std::unique_ptr<dd4hep::Detector>                     m_owner;
+    dd4hep::Detector&                                     m_description;
+    std::unique_ptr<dd4hep::rec::CellIDPositionConverter> m_converter;
+
+    /// Collect the sensitive placements of one readout below pv
+    void walk(dd4hep::PlacedVolume pv, TGeoHMatrix world, std::vector<std::pair<std::string, int> >& ids,
+              const dd4hep::Readout& ro, std::vector<std::uint64_t>& cells, std::vector<double>& xyz) const  {
+      const std::size_t nids = ids.size();
+      for( const auto& id : pv.volIDs() ) ids.emplace_back(id.first, int(id.second));
+      dd4hep::Volume vol = pv.volume();
+      if ( vol.isSensitive() && vol.sensitiveDetector().readout().ptr() == ro.ptr() )  {
+        const dd4hep::DDSegmentation::BitFieldCoder* coder = ro.idSpec().decoder();
+        dd4hep::CellID cell = 0;
+        for( const auto& id : ids )
+          for( const auto& f : coder->fields() )
+            if ( f.name() == id.first ) coder->set(cell, id.first, id.second);
+        cells.push_back(cell);
+        const double* t = world.GetTranslation();
+        for( int k = 0; k < 3; ++k ) xyz.push_back(t[k]/dd4hep::mm);
+      }
+      for( int i = 0; i < vol->GetNdaughters(); ++i )  {
+        dd4hep::PlacedVolume daughter(vol->GetNode(i));
+        TGeoHMatrix m(world);
+        m.Multiply(daughter->GetMatrix());
+        walk(daughter, m, ids, ro, cells, xyz);
+      }
+      ids.resize(nids);
+    }
+
+  public:
+    explicit Geometry(const std::vector<std::string>& compact)
+      : m_owner(dd4hep::Detector::make_unique(compact.empty() ? "dd4ship" : compact.front())),
+        m_description(*m_owner)  {
+      for( const auto& c : compact ) m_description.fromXML(c);
+      m_converter.reset(new dd4hep::rec::CellIDPositionConverter(m_description));
+    }
+
+    std::vector<std::string> readouts() const  {
+      std::vector<std::string> names;
+      for( const auto& r : m_description.readouts() ) names.push_back(r.first);
+      return names;
+    }
+
+    dd4ship::CellIDDecoder decoder(const std::string& readout) const  {
+      return dd4ship::CellIDDecoder(m_description.readout(readout).idSpec().fieldDescription());
+    }
+
+    /// Centre of the sensitive volume (bar, fibre core) of every cellID, (n, 3) in mm
+    py::array centres(py::array_t<std::uint64_t, py::array::c_style | py::array::forcecast> ids) const  {
+      std::vector<double> xyz(3*ids.size());
+      {
+        py::gil_scoped_release nogil;
+        const std::uint64_t* in = ids.data();
+        for( std::size_t i = 0, n = std::size_t(ids.size()); i < n; ++i )  {
+          const dd4hep::VolumeManagerContext* ctx = nullptr;
+          try  {
+            ctx = m_converter->findContext(in[i]);
+          }
+          catch(const std::exception&)  {
+            // cellID of no known volume
+          }
+          if ( !ctx )  {
+            xyz[3*i] = xyz[3*i+1] = xyz[3*i+2] = std::numeric_limits<double>::quiet_NaN();
+            continue;
+          }
+          const double* t = ctx->worldTransformation().GetTranslation();
+          for( int k = 0; k < 3; ++k ) xyz[3*i+k] = t[k]/dd4hep::mm;
+        }
+      }
+      return adopt(std::move(xyz)).reshape({ py::ssize_t(ids.size()), py::ssize_t(3) });
+    }
+
+    /// All sensitive volumes of a readout: volume cellIDs and centres [mm]
+    py::dict cells(const std::string& readout) const  {
+      dd4hep::Readout ro = m_description.readout(readout);
+      std::vector<std::uint64_t> ids;
+      std::vector<double>        xyz;
+      {
+        py::gil_scoped_release nogil;
+        std::vector<std::pair<std::string, int> > path;
+        for( const auto& d : m_description.world().children() )  {
+          dd4hep::DetElement det = d.second;
+          if ( !det.placement().isValid() ) continue;
+          walk(det.placement(), det.nominal().worldTransformation(), path, ro, ids, xyz);
+        }
+      }
+      const py::ssize_t n = py::ssize_t(ids.size());
+      py::dict out;
+      out["cellID"] = adopt(std::move(ids));
+      out["centre"] = adopt(std::move(xyz)).reshape({ n, py::ssize_t(3) });
+      return out;
+    }
+  };
+
+  /// Hits of one library event and collection, a view of the mapped file
+  py::array libraryHits(py::object self, std::uint64_t event, const std::string& coll)  {
+    const auto& lib = self.cast<const dd4ship::HitLibrary&>();
+    const int c = lib.collection(coll);
+    if ( c < 0 ) throw py::key_error("No collection " + coll + " in the hit library");
+    if ( event >= lib.events() ) throw py::index_error("Event " + std::to_string(event) + " out of range");
+    const dd4ship::HitLibrary::Range r = lib.hits(event, c);
+    py::array out(py::dtype::of<dd4ship::LibraryHit>(), { py::ssize_t(r.size()) }, {}, r.begin, self);
+    out.attr("setflags")(py::arg("write") = false);
+    return out;
+  }
+}
+
+PYBIND11_MODULE(dd4ship, m)  {
+  m.doc() = "DD4SHiP hits, cellID decoding and cell centres as NumPy arrays";
+  dd4ship::enableROOTThreadSafety();
+
+  py::class_<HitFile>(m, "HitFile")
+    .def(py::init<const std::string&, const std::string&>(), py::arg("path"), py::arg("tree") = "EVENT")
+    .def_property_readonly("entries", &HitFile::entries)
+    .def_property_readonly("collections", &HitFile::collections)
+    .def("read", &HitFile::read, py::arg("collection"), py::arg("start") = 0, py::arg("stop") = -1,
+         "Columns of a hit collection for entries [start, stop)");
+
+  py::class_<dd4ship::CellIDDecoder>(m, "CellIDDecoder")
+    .def(py::init<const std::string&>(), py::arg("descriptor"))
+    .def_static("forReadout", &dd4ship::CellIDDecoder::forReadout, py::arg("readout"), py::arg("compact") = "",
+                "Decoder of a readout of the compact file (built-in descriptors if empty)")
+    .def_property_readonly("fields", [](const dd4ship::CellIDDecoder& d)  {
+        std::vector<std::string> names;
+        for( const auto& f : d.fields() ) names.push_back(f.name);
+        return names;
+      })
+    .def("decode", &decode, py::arg("cellIDs"), "All fields of an array of cellIDs")
+    .def("field", &decodeField, py::arg("name"), py::arg("cellIDs"), "One field of an array of cellIDs");
+
+  py::class_<Geometry>(m, "Geometry")
+    .def(py::init<const std::vector<std::string>&>(), py::arg("compact"))
+    .def_property_readonly("readouts", &Geometry::readouts)
+    .def("decoder", &Geometry::decoder, py::arg("readout"))
+    .def("centres", &Geometry::centres, py::arg("cellIDs"), "Bar/fibre centres [mm], NaN if unknown")
+    .def("cells", &Geometry::cells, py::arg("readout"), "cellIDs and centres of all bars/fibres of a readout");
+
+  py::class_<dd4ship::HitLibrary>(m, "HitLibrary")
+    .def(py::init<const std::string&>(), py::arg("path"))
+    .def_property_readonly("events", &dd4ship::HitLibrary::events)
+    .def_property_readonly("collections", &dd4ship::HitLibrary::collections)
+    .def("hits", &libraryHits, py::arg("event"), py::arg("collection"),
+         "Read-only structured array (cellID, energy, time) on the mapped library");
+}
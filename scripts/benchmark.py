@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Small benchmark harness for DD4SHiP simulation jobs.
+
+Every measurement runs a command in a subprocess and records wall time and
+peak RSS of the child. Results are printed as a table and optionally stored
+as JSON with --json.
+
+    python3 scripts/benchmark.py sweep --compactFile SHiPCalo.xml --sweep scripts/sweep_energy_scan.txt -N 10
+    python3 scripts/benchmark.py physics --particles e- gamma --energy 10 -N 200
+    python3 scripts/benchmark.py killer --particles pi- --energy 30 -N 100
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+SCRIPTS = os.path.dirname(os.path.abspath(__file__))
+TOP = os.path.dirname(SCRIPTS)
+
+
+def measure(label, command, log=None, env=None):
+  """Run command, return dict with wall and CPU time [s] and peak RSS [MB] of the child"""
+  start = time.time()
+  with open(log or os.devnull, 'w') as out:
+    proc = subprocess.Popen(command, stdout=out, stderr=subprocess.STDOUT,
+                            env=dict(os.environ, **env) if env else None)
+    _, status, usage = os.wait4(proc.pid, 0)
+  wall = time.time() - start
+  result = {'label': label, 'wall_s': wall, 'cpu_s': usage.ru_utime + usage.ru_stime, 'maxrss_MB': usage.ru_maxrss / 1024.,
+            'status': os.waitstatus_to_exitcode(status), 'command': ' '.join(command)}
+  print('%-40s %8.1f s %9.1f MB %s' % (label, wall, result['maxrss_MB'],
+                                       '' if result['status'] == 0 else '(exit %d)' % result['status']))
+  return result
+
+
+def ddsimCommand(args, particle, energy, events, output, extra=(), position='0.0 0.0 -110.0*cm'):
+  return ['ddsim', '--compactFile', *args.compactFile, '--runType=batch', '-G', '-N=%d' % events,
+          '--steeringFile', args.steeringFile, '--outputFile=%s' % output,
+          '--gun.position', position, '--gun.direction', '0.0 0.0 1.0',
+          '--gun.energy', '%g*GeV' % energy, '--part.userParticleHandler=', '--gun.particle', particle,
+          *extra]
+
+
+def benchSweep(args):
+  """Separate ddsim invocations versus one scripts/sweep.py process, same steering file and options"""
+  sys.path.insert(0, SCRIPTS)
+  from sweep import parseSweep
+  points = parseSweep(args.sweep, args.numberOfEvents, 'bench_%(particle)s_%(energy)gGeV.root')
+  results = []
+  total = 0.
+  for p in points:
+    r = measure('ddsim %s %g GeV' % (p['particle'], p['energy']),
+                ddsimCommand(args, p['particle'], p['energy'], p['events'], p['output'],
+                             position='%g*mm %g*mm %g*mm' % p['position']))
+    total += r['wall_s']
+    results.append(r)
+  r = measure('sweep.py (%d points)' % len(points),
+              [sys.executable, os.path.join(SCRIPTS, 'sweep.py'), '--compactFile', *args.compactFile,
+               '--steeringFile', args.steeringFile, '--sweep', args.sweep, '-N', str(args.numberOfEvents),
+               '--outputPattern', 'bench_sweep_%(particle)s_%(energy)gGeV.root', '--part.userParticleHandler='])
+  results.append(r)
+  print('%-40s %8.1f s' % ('sum of ddsim invocations', total))
+  print('%-40s %8.1f s (%.1f s per point)' % ('saved by sweep', total - r['wall_s'], (total - r['wall_s']) / len(points)))
+  return results
+
+
+def benchPhysics(args):
+  """FTFP_BERT versus the DD4SHiP_EM list on e- and gamma guns.
+
+  Each configuration runs with 1 and with N events: the difference gives the
+  event rate, the extrapolation to 0 events the initialisation time.
+  """
+  results = []
+  print('%-40s %10s %10s %10s' % ('', 'init [s]', 'events/s', 'RSS [MB]'))
+  summary = []
+  for particle in args.particles:
+    for physics in ('FTFP_BERT', 'DD4SHiP_EM'):
+      extra = ['--physics.list', physics]
+      label = '%s %s %g GeV' % (physics, particle, args.energy)
+      one = measure(label + ' N=1', ddsimCommand(args, particle, args.energy, 1, 'bench_phys.root', extra))
+      many = measure(label + ' N=%d' % args.numberOfEvents,
+                     ddsimCommand(args, particle, args.energy, args.numberOfEvents, 'bench_phys.root', extra))
+      perEvent = (many['wall_s'] - one['wall_s']) / max(1, args.numberOfEvents - 1)
+      summary.append((label, one['wall_s'] - perEvent, 1. / perEvent if perEvent > 0 else 0., many['maxrss_MB']))
+      results += [one, many]
+  for s in summary:
+    print('%-40s %10.1f %10.2f %10.1f' % s)
+  return results
+
+
+def benchFastMuons(args):
+  """Full simulation versus the fast muon model (DD4SHIP_FASTMUONS=1) on mu- guns"""
+  results = []
+  rates = {}
+  for mode, env in (('full', {'DD4SHIP_FASTMUONS': '0'}), ('fast', {'DD4SHIP_FASTMUONS': '1'})):
+    label = '%s mu- %g GeV' % (mode, args.energy)
+    one = measure(label + ' N=1', ddsimCommand(args, 'mu-', args.energy, 1, 'bench_mu.root'), env=env)
+    many = measure(label + ' N=%d' % args.numberOfEvents,
+                   ddsimCommand(args, 'mu-', args.energy, args.numberOfEvents, 'bench_mu.root'), env=env)
+    perEvent = (many['wall_s'] - one['wall_s']) / max(1, args.numberOfEvents - 1)
+    rates[mode] = 1. / perEvent if perEvent > 0 else 0.
+    results += [one, many]
+  print('%-40s %10.2f events/s' % ('full simulation', rates['full']))
+  print('%-40s %10.2f events/s' % ('fast muons', rates['fast']))
+  if rates['full'] > 0:
+    print('%-40s %10.1f' % ('speedup', rates['fast'] / rates['full']))
+  return results
+
+
+def benchOutput(args):
+  """Synchronous ROOT output versus the writer thread (DD4SHIP_ASYNC_OUTPUT=1), detailed shower mode"""
+  results = []
+  rates = {}
+  extra = ['--enableDetailedShowerMode']
+  for particle in args.particles:
+    for mode, env in (('sync', {'DD4SHIP_ASYNC_OUTPUT': '0'}), ('async', {'DD4SHIP_ASYNC_OUTPUT': '1'})):
+      label = '%s output %s %g GeV' % (mode, particle, args.energy)
+      one = measure(label + ' N=1', ddsimCommand(args, particle, args.energy, 1, 'bench_out.root', extra), env=env)
+      many = measure(label + ' N=%d' % args.numberOfEvents,
+                     ddsimCommand(args, particle, args.energy, args.numberOfEvents, 'bench_out.root', extra), env=env)
+      perEvent = (many['wall_s'] - one['wall_s']) / max(1, args.numberOfEvents - 1)
+      rates[(particle, mode)] = 1. / perEvent if perEvent > 0 else 0.
+      results += [one, many]
+  for particle in args.particles:
+    sync, async_ = rates[(particle, 'sync')], rates[(particle, 'async')]
+    print('%-40s %10.2f -> %10.2f events/s' % ('output %s' % particle, sync, async_))
+  return results
+
+
+def layerSums(dqmFile):
+  """Per-layer energy sums {collection: [MeV per layer]} from a DD4SHiPDQMHistograms output"""
+  import ROOT
+  sums = {}
+  f = ROOT.TFile.Open(dqmFile)
+  if not f or f.IsZombie():
+    return sums
+  for key in f.GetListOfKeys():
+    name = key.GetName()
+    if name.startswith('h_layer_edep_'):
+      h = key.ReadObj()
+      sums[name[len('h_layer_edep_'):]] = [h.GetBinContent(i + 1) for i in range(h.GetNbinsX())]
+  f.Close()
+  return sums
+
+
+def benchKiller(args):
+  """Validation and CPU time of the track killer (DD4SHIP_TRACKKILLER=1) for --particles at --energy.
+
+  The defaults are e- and gamma at 10 GeV; hadron showers, where the killer
+  matters most, need e.g. --particles pi- --energy 30.
+
+  Both runs use the same seed and fill the per-layer energy sums of the
+  DQM action; the report lists the mean energy per layer with the killer
+  off and on and the relative change.
+  """
+  results = []
+  cpu = {}
+  layers = {}
+  for mode, env in (('off', {'DD4SHIP_TRACKKILLER': '0'}), ('on', {'DD4SHIP_TRACKKILLER': '1'})):
+    dqm = 'bench_killer_dqm_%s.root' % mode
+    steering = 'bench_killer_steering_%s.py' % mode
+    with open(steering, 'w') as out:
+      out.write('exec(open(%r).read())\n' % os.path.abspath(args.steeringFile))
+      out.write('SIM.random.seed = 12345\n')
+      out.write('SIM.action.event = [{"name": "DD4SHiPDQMHistograms/DQM", "parameter": {"Output": %r}}]\n' % dqm)
+    local = argparse.Namespace(**dict(vars(args), steeringFile=steering))
+    for particle in args.particles:
+      label = 'killer %s %s %g GeV' % (mode, particle, args.energy)
+      one = measure(label + ' N=1', ddsimCommand(local, particle, args.energy, 1, 'bench_killer.root'), env=env)
+      many = measure(label + ' N=%d' % args.numberOfEvents,
+                     ddsimCommand(local, particle, args.energy, args.numberOfEvents, 'bench_killer.root'), env=env)
+      cpu[(particle, mode)] = (many['cpu_s'] - one['cpu_s']) / max(1, args.numberOfEvents - 1)
+      layers[(particle, mode)] = layerSums(dqm)
+      results += [one, many]
+  for particle in args.particles:
+    off, on = cpu[(particle, 'off')], cpu[(particle, 'on')]
+    print('%-40s %10.3f -> %10.3f s/event (%.1f %% saved)' % ('CPU %s' % particle, off, on,
+                                                               100. * (off - on) / off if off > 0 else 0.))
+    for coll, sumsOff in sorted(layers[(particle, 'off')].items()):
+      sumsOn = layers[(particle, 'on')].get(coll, [])
+      print('%-40s %6s %14s %14s %9s' % ('per-layer energy ' + coll, 'layer', 'off [MeV]', 'on [MeV]', 'on/off'))
+      for layer, e in enumerate(sumsOff):
+        eOn = sumsOn[layer] if layer < len(sumsOn) else 0.
+        if e == 0 and eOn == 0:
+          continue
+        print('%-40s %6d %14.3f %14.3f %9.4f' % ('', layer, e / args.numberOfEvents, eOn / args.numberOfEvents,
+                                                eOn / e if e > 0 else 0.))
+      results.append({'label': 'layers %s %s' % (particle, coll), 'off': sumsOff, 'on': sumsOn})
+  return results
+
+
+BENCHMARKS = {'sweep': benchSweep,
+              'physics': benchPhysics,
+              'fastmuons': benchFastMuons,
+              'output': benchOutput,
+              'killer': benchKiller}
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('benchmark', choices=sorted(BENCHMARKS))
+  parser.add_argument('--compactFile', nargs='+', default=[os.path.join(TOP, 'SHiPCalo.xml')])
+  parser.add_argument('--steeringFile', default=os.path.join(TOP, 'steering.py'))
+  parser.add_argument('--sweep', default=os.path.join(SCRIPTS, 'sweep_energy_scan.txt'))
+  parser.add_argument('-N', '--numberOfEvents', type=int, default=10)
+  parser.add_argument('--particles', nargs='+', default=['e-', 'gamma'])
+  parser.add_argument('--energy', type=float, default=10., help='gun energy in GeV')
+  parser.add_argument('--json', default=None, help='store the results in this file')
+  args = parser.parse_args()
+
+  print('%-40s %10s %12s' % ('measurement', 'wall', 'peak RSS'))
+  results = BENCHMARKS[args.benchmark](args)
+  if args.json:
+    with open(args.json, 'w') as out:
+      json.dump(results, out, indent=2)
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""Scan SplitCal layer layouts in one process and tabulate resolution and containment.
+
+Every variant (layer_codes, bar and absorber thickness, HPL fibre layers) is
+built with the existing detector factory as its own subdetector with its own
+readout. All variants are placed side by side in one generated compact file
+(layout_scan.xml), so geometry, materials and physics tables are set up once.
+Each variant is then simulated as a separate Geant4 run, with the gun in
+front of it. The DD4SHiPLayoutMetrics event action appends one row per run
+to the CSV table, which is printed at the end.
+
+Variants are given as a grid on the command line:
+
+    python3 scripts/layoutScan.py --layerCodes 1727374717273747 172737471727374717273747 \\
+        --barThickness 10 5 --absorberThickness 2.8 5.6 --particle e- --energy 10 -N 500
+
+or as a file with one variant per line ('#' starts a comment):
+
+    # label   layer_codes                    bar[mm]  absorber[mm]  [hpln_fibre_layers]
+    base      17273747172737471727374756817  10       2.8
+    thick_pb  17273747172737471727374756817  10       5.6           3
+
+hpln_fibre_layers is only read by the DD4hep_SplitCal and DD4hep_SplitCalHPLs
+factories; giving it for a template built by another factory (such as the
+default SplitCalBars.xml, DD4hep_SplitCalWideBars_and_Basis) is an error.
+Thicknesses not given keep the template values. Neighbouring variants are
+Pitch apart in x and y, far enough that showers do not reach the next one.
+"""
+import argparse
+import csv
+import itertools
+import math
+import os
+import re
+import time
+import xml.etree.ElementTree as ET
+
+SCRIPTS = os.path.dirname(os.path.abspath(__file__))
+TOP = os.path.dirname(SCRIPTS)
+UNITS = {'mm': 1., 'cm': 10., 'm': 1000.}
+# Factories that read hpln_fibre_layers (src/SplitCal_geo.cpp, src/SplitCal_HPLs_geo.cpp)
+HPLN_FACTORIES = ('DD4hep_SplitCal', 'DD4hep_SplitCalHPLs')
+# Vis attributes the SplitCal templates use but no compact file defines
+DEFAULT_VIS = {'SplitCalVis': {'alpha': '0.0', 'r': '0.4', 'g': '0.4', 'b': '0.4', 'showDaughters': 'true',
+                               'visible': 'false'},
+               'SplitCalPassiveVis': {'alpha': '1.0', 'r': '1.0', 'g': '0.0', 'b': '0.0', 'showDaughters': 'true',
+                                      'visible': 'true'}}
+
+
+def length(value):
+  """Length attribute of the compact files (e.g. '0.28*cm') in mm"""
+  return float(eval(value, {'__builtins__': {}}, UNITS))
+
+
+def parseVariants(args):
+  variants = []
+  if args.scan:
+    with open(args.scan) as scanFile:
+      for line in scanFile:
+        line = line.split('#', 1)[0].split()
+        if not line:
+          continue
+        if len(line) < 4:
+          raise RuntimeError("Bad scan line (need label layer_codes bar absorber): %s" % ' '.join(line))
+        variants.append({'label': line[0], 'layer_codes': line[1],
+                         'bar': float(line[2]), 'absorber': float(line[3]),
+                         'hpln': int(line[4]) if len(line) > 4 else None})
+  else:
+    for codes, bar, absorber, hpln in itertools.product(args.layerCodes, args.barThickness or [None],
+                                                          args.absorberThickness or [None],
+                                                          args.hplnFibreLayers or [None]):
+      label = 'v%d' % len(variants)
+      variants.append({'label': label, 'layer_codes': codes, 'bar': bar, 'absorber': absorber, 'hpln': hpln})
+  if len(variants) > 255:
+    raise RuntimeError("At most 255 variants per scan (system field of the readout)")
+  for v in variants:
+    if not re.fullmatch('[1-8]+', v['layer_codes']):
+      raise RuntimeError("Bad layer codes for %s: only 1-8 allowed" % v['label'])
+  return variants
+
+
+def depth(det, codes):
+  """Thickness of the layer stack as laid out by the SplitCal factories [mm]"""
+  def z(tag):
+    child = det.find(tag)
+    return length(child.get('z')) if child is not None and child.get('z') else 0.
+  widebar = det.find('widebar')
+  gap = length(widebar.get('extrazgap', '0*mm')) if widebar is not None else 0.
+  per = {'1': z('widebar'), '2': z('widebar'), '3': z('thinbar'), '4': z('thinbar'),
+         '5': z('hplbox'), '6': z('hplbox'), '7': z('passive_layer') + gap, '8': z('split')}
+  return sum(per[c] for c in codes)
+
+
+def rearLayerStart(codes, n):
+  """Layer index of the n-th last sensitive bar layer (codes 1-4)"""
+  active = [i for i, c in enumerate(codes) if c in '1234']
+  return active[-n] if len(active) >= n else (active[0] if active else -1)
+
+
+def buildCompact(args, variants, fileName):
+  """Write the compact file holding all variants; fill centre, front z and readout per variant"""
+  template = ET.parse(args.template).getroot()
+  det0 = [d for d in template.iter('detector') if not args.detector or d.get('name') == args.detector]
+  if not det0:
+    raise RuntimeError("No detector %s in %s" % (args.detector, args.template))
+  det0 = det0[0]
+  readouts = ET.parse(args.readouts).getroot()
+  ro0 = [r for r in readouts.iter('readout') if r.get('name') == det0.get('readout')]
+  if not ro0:
+    raise RuntimeError("No readout %s in %s" % (det0.get('readout'), args.readouts))
+  ro0 = ro0[0]
+  if any(v['hpln'] is not None for v in variants) and det0.get('type') not in HPLN_FACTORIES:
+    raise RuntimeError("Detector %s is built by %s, which ignores hpln_fibre_layers (read only by %s)" %
+                       (det0.get('name'), det0.get('type'), ', '.join(HPLN_FACTORIES)))
+
+  ncols = int(math.ceil(math.sqrt(len(variants))))
+  root = ET.Element('lccdd')
+  ET.SubElement(root, 'info', name='layout_scan', title='SplitCal layout scan', author='scripts/layoutScan.py',
+                url='', status='development', version='1')
+  includes = ET.SubElement(root, 'includes')
+  for ref in ('elements.xml', 'materials.xml'):
+    ET.SubElement(includes, 'file', ref=os.path.join(TOP, ref))
+  define = ET.SubElement(root, 'define')
+  detectors = []
+  for v in variants:
+    det = ET.fromstring(ET.tostring(det0))
+    det.set('layer_codes', v['layer_codes'])
+    if v['hpln'] is not None:
+      det.set('hpln_fibre_layers', str(v['hpln']))
+    if v['bar'] is not None:
+      for tag in ('widebar', 'thinbar'):
+        if det.find(tag) is not None:
+          det.find(tag).set('z', '%g*mm' % v['bar'])
+    if v['absorber'] is not None and det.find('passive_layer') is not None:
+      det.find('passive_layer').set('z', '%g*mm' % v['absorber'])
+    v['depth'] = depth(det, v['layer_codes'])
+    detectors.append(det)
+  maxDepth = max(v['depth'] for v in variants)
+  side = max(30000., (ncols + 1) * args.pitch, 2 * maxDepth + 4000.)
+  for name, value in (('world_side', '%g*mm' % side), ('world_x', 'world_side'), ('world_y', 'world_side'),
+                      ('world_z', 'world_side')):
+    ET.SubElement(define, 'constant', name=name, value=value)
+  display = ET.SubElement(root, 'display')
+  for name in ('InvisibleNoDaughters', 'InvisibleWithDaughters'):
+    ET.SubElement(display, 'vis', name=name, showDaughters='true' if 'With' in name else 'false', visible='false')
+  known = {}
+  for compact in (template, readouts):
+    for vis in compact.iter('vis'):
+      known.setdefault(vis.get('name'), vis)
+  used = [e.get('vis') for e in det0.iter() if e.get('vis')]
+  for name in sorted(set(used) - set(('InvisibleNoDaughters', 'InvisibleWithDaughters'))):
+    if name in known:
+      display.append(known[name])
+    elif name in DEFAULT_VIS:
+      ET.SubElement(display, 'vis', name=name, **DEFAULT_VIS[name])
+    else:
+      raise RuntimeError("Vis attributes %s used by %s are defined neither in %s nor in %s" %
+                         (name, det0.get('name'), args.template, args.readouts))
+  ros = ET.SubElement(root, 'readouts')
+  dets = ET.SubElement(root, 'detectors')
+  for k, (v, det) in enumerate(zip(variants, detectors)):
+    ro = ET.fromstring(ET.tostring(ro0))
+    v['readout'] = '%s_%s' % (ro0.get('name'), v['label'])
+    ro.set('name', v['readout'])
+    ros.append(ro)
+    det.set('id', str(k + 1))
+    det.set('name', 'LayoutScan_%s' % v['label'])
+    det.set('readout', v['readout'])
+    det.find('box').set('z', '%g*mm' % (v['depth'] * 1.001 + 1.))
+    v['centre'] = (((k % ncols) - 0.5 * (ncols - 1)) * args.pitch, ((k // ncols) - 0.5 * (ncols - 1)) * args.pitch)
+    pos = det.find('position')
+    pos.set('x', '%g*mm' % v['centre'][0])
+    pos.set('y', '%g*mm' % v['centre'][1])
+    v['front'] = length(pos.get('z', '0')) - 0.5 * v['depth']
+    v['rearStart'] = rearLayerStart(v['layer_codes'], args.rearLayers)
+    dets.append(det)
+  ET.ElementTree(root).write(fileName)
+  return fileName
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('--scan', default=None, help='file with one variant per line')
+  parser.add_argument('--layerCodes', nargs='+', default=[], help='grid: layer_codes strings')
+  parser.add_argument('--barThickness', type=float, nargs='+', default=None, help='grid: bar thickness [mm]')
+  parser.add_argument('--absorberThickness', type=float, nargs='+', default=None, help='grid: absorber thickness [mm]')
+  parser.add_argument('--hplnFibreLayers', type=int, nargs='+', default=None, help='grid: hpln_fibre_layers')
+  parser.add_argument('--template', default=os.path.join(TOP, 'Detectors/PID/ECAL/SplitCalBars.xml'),
+                      help='compact file with the template <detector>')
+  parser.add_argument('--detector', default=None, help='name of the template detector (default: the first)')
+  parser.add_argument('--readouts', default=os.path.join(TOP, 'Detectors/PID/ECAL/SplitCal.xml'),
+                      help='compact file with the template readout')
+  parser.add_argument('--pitch', type=float, default=4000., help='distance between variants [mm]')
+  parser.add_argument('--particle', default='e-')
+  parser.add_argument('--energy', type=float, default=10., help='gun energy [GeV]')
+  parser.add_argument('-N', '--numberOfEvents', type=int, default=100, help='events per variant')
+  parser.add_argument('--rearLayers', type=int, default=3, help='last N bar layers counted as rear')
+  parser.add_argument('--lateralRadius', type=float, default=100., help='radius for the lateral leakage [mm]')
+  parser.add_argument('--physicsList', default='FTFP_BERT')
+  parser.add_argument('--calo', default='Geant4ScintillatorCalorimeterAction', help='calorimeter sensitive action')
+  parser.add_argument('--compact', default='layout_scan.xml', help='generated compact file')
+  parser.add_argument('--output', default='layout_scan.csv', help='CSV table of the metrics')
+  args = parser.parse_args()
+
+  variants = parseVariants(args)
+  if not variants:
+    parser.error('no variants: give --scan or --layerCodes')
+  tStart = time.time()
+  buildCompact(args, variants, args.compact)
+  if os.path.exists(args.output):
+    os.remove(args.output)
+
+  import DDG4
+  from g4units import GeV, mm
+
+  kernel = DDG4.Kernel()
+  kernel.loadGeometry(str("file:" + os.path.abspath(args.compact)))
+  DDG4.importConstants(kernel.detectorDescription())
+  geant4 = DDG4.Geant4(kernel, tracker='Geant4TrackerWeightedAction', calo=args.calo)
+  kernel.UI = ''
+
+  gun = DDG4.GeneratorAction(kernel, "Geant4ParticleGun/Gun")
+  gun.Standalone = False
+  gun.direction = (0.0, 0.0, 1.0)
+  gun.multiplicity = 1
+  gun.isotrop = False
+  gun.particle = args.particle
+  gun.energy = args.energy * GeV
+  geant4.buildInputStage([gun])
+
+  metrics = DDG4.EventAction(kernel, 'DD4SHiPLayoutMetrics/Metrics', True)
+  metrics.Output = args.output
+  metrics.BeamEnergy = args.energy * GeV
+  metrics.LateralRadius = args.lateralRadius * mm
+  kernel.eventAction().adopt(metrics)
+
+  geant4.setupDetectors()
+  geant4.setupPhysics(args.physicsList)
+
+  kernel.configure()
+  kernel.initialize()
+  tInit = time.time()
+  print('layoutScan: %d variants, initialisation took %.1f s' % (len(variants), tInit - tStart))
+
+  times = {}
+  for v in variants:
+    tRun = time.time()
+    metrics.Label = v['label']
+    metrics.Collections = [v['readout']]
+    metrics.Centre = [v['centre'][0] * mm, v['centre'][1] * mm]
+    metrics.RearLayerStart = v['rearStart']
+    gun.position = (v['centre'][0] * mm, v['centre'][1] * mm, (v['front'] - 100.) * mm)
+    kernel.runEvents(args.numberOfEvents)
+    times[v['label']] = (time.time() - tRun) / max(1, args.numberOfEvents)
+
+  kernel.terminate()
+
+  with open(args.output) as table:
+    rows = {r['label']: r for r in csv.DictReader(table)}
+  print('%-12s %-32s %7s %7s %8s %17s %9s %7s %7s %7s %8s' %
+        ('variant', 'layer_codes', 'bar', 'abs', 'depth', 'resolution', 'samp.fr', 'layer', 'rear', 'lateral', 's/event'))
+  for v in variants:
+    r = rows.get(v['label'])
+    if r is None:
+      print('%-12s no result' % v['label'])
+      continue
+    codes = v['layer_codes'] if len(v['layer_codes']) <= 32 else v['layer_codes'][:29] + '...'
+    print('%-12s %-32s %7s %7s %8.1f %8.4f +- %.4f %9.4f %7.2f %7.4f %7.4f %8.3f' %
+          (v['label'], codes, '%g' % v['bar'] if v['bar'] is not None else '-',
+           '%g' % v['absorber'] if v['absorber'] is not None else '-', v['depth'],
+           float(r['resolution']), float(r['resolution_err']), float(r['sampling_fraction']),
+           float(r['mean_layer']), float(r['rear_fraction']), float(r['lateral_leakage']), times[v['label']]))
+  print('layoutScan: total %.1f s (initialisation %.1f s, paid once), table in %s' %
+        (time.time() - tStart, tInit - tStart, args.output))
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Run a list of gun settings as separate Geant4 runs in one process.
+
+The job is configured by DD4hepSimulation as ddsim configures it from the
+same steering file and options (filters, actions, physics hooks, output,
+random seed); only the gun settings, the event count and the output file
+change from point to point. The geometry, sensitive detectors and physics
+tables are built once, every sweep point is then simulated as its own run
+with its own output file. Before each point the random engine is reseeded
+with SIM.random.seed, as a separate ddsim call would be. Options not known
+to this script are passed on to DD4hepSimulation (e.g.
+--part.userParticleHandler=).
+
+Sweep file: one point per line, '#' starts a comment
+
+    # particle  energy[GeV]  x[mm]  y[mm]  z[mm]  [events]  [output]
+    pi-         10           0      0      -1100
+    pi-         20           0      0      -1100   200      pi_20GeV.root
+
+Example (20-point energy scan, see scripts/sweep_energy_scan.txt):
+
+    python3 scripts/sweep.py --compactFile SHiPCalo.xml --steeringFile steering.py \\
+        --sweep scripts/sweep_energy_scan.txt -N 100
+"""
+import argparse
+import os
+import sys
+import time
+
+
+def parseSweep(fileName, defaultEvents, pattern):
+  points = []
+  with open(fileName) as sweepFile:
+    for line in sweepFile:
+      line = line.split('#', 1)[0].split()
+      if not line:
+        continue
+      if len(line) < 5:
+        raise RuntimeError("Bad sweep line (need particle energy x y z): %s" % ' '.join(line))
+      point = {'particle': line[0],
+               'energy': float(line[1]),
+               'position': tuple(float(v) for v in line[2:5]),
+               'events': int(line[5]) if len(line) > 5 else defaultEvents}
+      point['output'] = line[6] if len(line) > 6 else pattern % point
+      points.append(point)
+  return points
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('--compactFile', required=True, nargs='+')
+  parser.add_argument('--steeringFile', default=None, help='ddsim steering file')
+  parser.add_argument('--sweep', required=True, help='file with one particle/energy/position setting per line')
+  parser.add_argument('-N', '--numberOfEvents', type=int, default=10, help='events per point if not in the sweep file')
+  parser.add_argument('--outputPattern', default='%(particle)s_%(energy)gGeV.root',
+                      help='output file name per point (python %%-format of the point fields)')
+  parser.add_argument('--direction', type=float, nargs=3, default=(0.0, 0.0, 1.0))
+  args, ddsimArgs = parser.parse_known_args()
+
+  tStart = time.time()
+  points = parseSweep(args.sweep, args.numberOfEvents, args.outputPattern)
+
+  import DDG4
+  from DDSim.DD4hepSimulation import DD4hepSimulation
+
+  # The ddsim command line of the first point
+  first = points[0]
+  argv = ['ddsim', '--compactFile', *args.compactFile, '--runType=batch', '--enableGun',
+          '-N=%d' % first['events'], '--outputFile=%s' % first['output'],
+          '--gun.particle', first['particle'], '--gun.energy', '%g*GeV' % first['energy'],
+          '--gun.position', '%g*mm %g*mm %g*mm' % first['position'],
+          '--gun.direction', '%g %g %g' % tuple(args.direction)]
+  if args.steeringFile:
+    argv += ['--steeringFile', args.steeringFile]
+  SIM = DD4hepSimulation()
+  sys.argv = argv + ddsimArgs
+  SIM.parseOptions()
+
+  # Hooks into the configuration done by SIM.run(): keep the gun, write one file per run
+  # and replace the single kernel.run() by the sweep.
+  guns = []
+  outputs = []
+  makeGenerator = DDG4.GeneratorAction
+  setupROOTOutput = DDG4.Geant4.setupROOTOutput
+
+  def generatorAction(kernel, nam, *a, **kw):
+    action = makeGenerator(kernel, nam, *a, **kw)
+    if nam.startswith('Geant4ParticleGun/'):
+      guns.append(action)
+    return action
+
+  def rootOutput(self, *a, **kw):
+    action = setupROOTOutput(self, *a, **kw)
+    action.FilesByRun = True
+    outputs.append(action)
+    return action
+
+  def sweep(kernel):
+    from g4units import GeV, mm
+    tInit = time.time()
+    print('sweep: initialisation took %.1f s, running %d points' % (tInit - tStart, len(points)))
+    if not guns:
+      raise RuntimeError('sweep: no particle gun was configured by DD4hepSimulation')
+    if not outputs:
+      print('sweep: no Geant4Output2ROOT output, the runs are not split into files')
+    random = DDG4.Geant4Random.instance() if SIM.random.seed is not None else None
+    base = os.path.splitext(first['output'])[0]
+    for run, point in enumerate(points):
+      tRun = time.time()
+      for gun in guns:
+        gun.particle = point['particle']
+        gun.energy = point['energy'] * GeV
+        gun.position = tuple(v * mm for v in point['position'])
+      if random:
+        random.setSeed(SIM.random.seed)
+      kernel.runEvents(point['events'])
+      produced = '%s.run%08d.root' % (base, run)
+      if outputs and os.path.exists(produced):
+        os.replace(produced, point['output'])
+      print('sweep: run %d %s %g GeV -> %s: %d events in %.1f s' %
+            (run, point['particle'], point['energy'], point['output'], point['events'], time.time() - tRun))
+    print('sweep: total %.1f s (initialisation %.1f s, paid once)' % (time.time() - tStart, tInit - tStart))
+    return 1
+
+  DDG4.GeneratorAction = generatorAction
+  DDG4.Geant4.setupROOTOutput = rootOutput
+  DDG4.Kernel.run = sweep
+  SIM.run()
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,356 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Material budget of the SplitCal and HCAL stacks without simulation.
+//
+//   geoPluginRun -input SHiPCalo.xml -plugin DD4SHiP_MaterialBudget \
+//                -nx 216 -ny 216 -threads 8 -output material_budget.root
+//
+// A grid of straight rays parallel to z is traced through the TGeo
+// geometry, one navigator per thread. Every step is booked with
+// step/X0 and step/lambda_I to the layer of the volume and to its
+// material. A layer is the triple (system, field, value): the subdetector
+// ("system" volume ID), the first of the -fields found on the placement
+// path (e.g. splitcal_layer, splitcal_passivelayer or hcal_layer) and its
+// value (the position in layer_codes). Layers of different subdetectors
+// are therefore never summed. Steps outside any layer go to an entry
+// printed as "outside".
+//
+// Output (ROOT file):
+//   x0_map, lambda_map          total X0 and lambda_I per ray (x, y)
+//   x0_layer, lambda_layer      mean per layer over all rays, one bin per
+//                               layer, labelled subdetector/field:value
+//   x0_cumulative, ...          cumulative profiles, layers ordered by
+//                               subdetector, then value
+//   x0_layer_material, ...      mean per layer and material
+// The per-layer profile and the per-material totals are also printed.
+//
+// Options (lengths accept units, e.g. -xmin -108*cm):
+//   -nx/-ny N            rays in x/y                     (100)
+//   -xmin/-xmax/-ymin/-ymax  ray grid                    (+-108 cm)
+//   -zmin/-zmax          start and end of the rays       (+-14 m)
+//   -threads N           worker threads (0: hardware)    (0)
+//   -fields a,b,...      layer fields, first match wins
+//   -output file         ROOT output                     (material_budget.root)
+//
+//==========================================================================
+#include <DD4hep/DetFactoryHelper.h>
+#include <DD4hep/Printout.h>
+#include <DD4hep/Volumes.h>
+
+#include <TFile.h>
+#include <TGeoManager.h>
+#include <TGeoNavigator.h>
+#include <TGeoNode.h>
+#include <TGeoMaterial.h>
+#include <TH1D.h>
+#include <TH2D.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace dd4hep;
+
+namespace {
+
+  struct BudgetConfig  {
+    int    nx = 100, ny = 100;
+    double xmin = -108*dd4hep::cm, xmax = 108*dd4hep::cm;
+    double ymin = -108*dd4hep::cm, ymax = 108*dd4hep::cm;
+    double zmin = -14*dd4hep::m,   zmax = 14*dd4hep::m;
+    int    threads = 0;
+    std::vector<std::string> fields { "splitcal_layer", "splitcal_passivelayer", "splitcal_split_layer",
+                                      "splitcal_hpl_layer", "hcal_layer", "hcal_passivelayer",
+                                      "layer", "passivelayer" };
+    std::string output { "material_budget.root" };
+  };
+
+  /// X0 and lambda_I in units of the respective length
+  struct Budget  {
+    double x0 = 0, lambda = 0;
+    Budget& operator+=(const Budget& b)  { x0 += b.x0; lambda += b.lambda; return *this; }
+  };
+
+  /// Layer of a volume: subdetector, index of the layer field in BudgetConfig::fields and its value
+  struct LayerKey  {
+    int system = -1, field = -1, value = -1;
+    bool outside() const  { return field < 0; }
+    /// Order by subdetector, then position in layer_codes, so that the profiles follow the stacks
+    bool operator<(const LayerKey& k) const  {
+      if ( system != k.system ) return system < k.system;
+      if ( value  != k.value  ) return value < k.value;
+      return field < k.field;
+    }
+  };
+
+  /// Sums of one worker thread
+  struct BudgetSums  {
+    std::map<LayerKey, Budget>                               layers;
+    std::map<LayerKey, std::map<const TGeoMaterial*, Budget> > materials;
+    long                                                stuck = 0;
+  };
+
+  class BudgetTracer  {
+    const BudgetConfig&                           m_cfg;
+    std::unordered_map<const TGeoNode*, LayerKey> m_idsOf;   // -1: node carries no such volume ID
+
+    const LayerKey& nodeIDs(const TGeoNode* node)  {
+      auto it = m_idsOf.find(node);
+      if ( it != m_idsOf.end() ) return it->second;
+      LayerKey key;
+      try  {
+        const PlacedVolume::VolIDs& ids = PlacedVolume(const_cast<TGeoNode*>(node)).volIDs();
+        auto sys = std::find_if(ids.begin(), ids.end(), [](const auto& v) { return v.first == "system"; });
+        if ( sys != ids.end() ) key.system = sys->second;
+        for( std::size_t f = 0; f < m_cfg.fields.size(); ++f )  {
+          auto id = std::find_if(ids.begin(), ids.end(), [&](const auto& v) { return v.first == m_cfg.fields[f]; });
+          if ( id != ids.end() )  {
+            key.field = int(f);
+            key.value = id->second;
+            break;
+          }
+        }
+      }
+      catch(const std::exception&)  {
+        // node without DD4hep placement data
+      }
+      return m_idsOf[node] = key;
+    }
+
+    LayerKey layer(TGeoNavigator* nav)  {
+      LayerKey key;
+      const int level = nav->GetLevel();
+      for( int up = 0; up <= level && (key.outside() || key.system < 0); ++up )  {
+        const LayerKey& ids = nodeIDs(up == 0 ? nav->GetCurrentNode() : nav->GetMother(up));
+        if ( key.outside() && !ids.outside() )  {
+          key.field = ids.field;
+          key.value = ids.value;
+        }
+        if ( key.system < 0 ) key.system = ids.system;
+      }
+      return key.outside() ? LayerKey() : key;
+    }
+
+  public:
+    explicit BudgetTracer(const BudgetConfig& cfg) : m_cfg(cfg)  {}
+
+    /// Trace one ray along +z, return its total budget
+    Budget trace(TGeoNavigator* nav, double x, double y, BudgetSums& sums)  {
+      Budget total;
+      double z = m_cfg.zmin;
+      int    zeroSteps = 0;
+      nav->InitTrack(x, y, z, 0e0, 0e0, 1e0);
+      while( !nav->IsOutside() && z < m_cfg.zmax )  {
+        const TGeoNode*     node = nav->GetCurrentNode();
+        const TGeoMaterial* mat  = node->GetVolume()->GetMaterial();
+        const LayerKey      lay  = layer(nav);
+        nav->FindNextBoundaryAndStep(m_cfg.zmax - z);
+        const double step = nav->GetStep();
+        if ( step <= 0e0 )  {
+          if ( ++zeroSteps > 10 )  {
+            ++sums.stuck;
+            break;
+          }
+          continue;
+        }
+        zeroSteps = 0;
+        z += step;
+        Budget b;
+        b.x0     = mat->GetRadLen() > 0e0 ? step/mat->GetRadLen() : 0e0;
+        b.lambda = mat->GetIntLen() > 0e0 ? step/mat->GetIntLen() : 0e0;
+        total += b;
+        sums.layers[lay] += b;
+        sums.materials[lay][mat] += b;
+      }
+      return total;
+    }
+  };
+
+  std::vector<std::string> split(const std::string& s)  {
+    std::vector<std::string> out;
+    std::stringstream str(s);
+    std::string tok;
+    while( std::getline(str, tok, ',') ) if ( !tok.empty() ) out.push_back(tok);
+    return out;
+  }
+
+  long material_budget(Detector& description, int argc, char** argv)  {
+    BudgetConfig cfg;
+    for( int i = 0; i < argc; ++i )  {
+      const char* a = argv[i];
+      const bool  more = i+1 < argc;
+      if      ( more && ::strcmp(a, "-nx") == 0 )      cfg.nx = ::atoi(argv[++i]);
+      else if ( more && ::strcmp(a, "-ny") == 0 )      cfg.ny = ::atoi(argv[++i]);
+      else if ( more && ::strcmp(a, "-xmin") == 0 )    cfg.xmin = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-xmax") == 0 )    cfg.xmax = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-ymin") == 0 )    cfg.ymin = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-ymax") == 0 )    cfg.ymax = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-zmin") == 0 )    cfg.zmin = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-zmax") == 0 )    cfg.zmax = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-threads") == 0 ) cfg.threads = ::atoi(argv[++i]);
+      else if ( more && ::strcmp(a, "-fields") == 0 )  cfg.fields = split(argv[++i]);
+      else if ( more && ::strcmp(a, "-output") == 0 )  cfg.output = argv[++i];
+      else except("DD4SHiP_MaterialBudget", "Unknown or incomplete option %s", a);
+    }
+    if ( cfg.nx < 1 || cfg.ny < 1 || cfg.zmax <= cfg.zmin )
+      except("DD4SHiP_MaterialBudget", "Invalid ray grid.");
+    const int nthreads = cfg.threads > 0 ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    const double dx = (cfg.xmax - cfg.xmin)/cfg.nx;
+    const double dy = (cfg.ymax - cfg.ymin)/cfg.ny;
+    TGeoManager& mgr = description.manager();
+    if ( !mgr.IsClosed() ) mgr.CloseGeometry();
+    mgr.SetMaxThreads(nthreads);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<Budget>     rays(std::size_t(cfg.nx)*cfg.ny);
+    std::vector<BudgetSums> sums(nthreads);
+    std::vector<std::thread> workers;
+    for( int t = 0; t < nthreads; ++t )  {
+      workers.emplace_back([&, t]()  {
+        TGeoNavigator* nav = mgr.GetCurrentNavigator();
+        if ( !nav ) nav = mgr.AddNavigator();
+        BudgetTracer tracer(cfg);
+        for( int iy = t; iy < cfg.ny; iy += nthreads )  {
+          const double y = cfg.ymin + (iy + 0.5)*dy;
+          for( int ix = 0; ix < cfg.nx; ++ix )
+            rays[std::size_t(iy)*cfg.nx + ix] = tracer.trace(nav, cfg.xmin + (ix + 0.5)*dx, y, sums[t]);
+        }
+        mgr.RemoveNavigator(nav);
+      });
+    }
+    for( auto& w : workers ) w.join();
+    mgr.SetMaxThreads(0);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Merge the threads
+    BudgetSums all;
+    for( const auto& s : sums )  {
+      for( const auto& l : s.layers ) all.layers[l.first] += l.second;
+      for( const auto& l : s.materials )
+        for( const auto& m : l.second ) all.materials[l.first][m.first] += m.second;
+      all.stuck += s.stuck;
+    }
+    const double nrays = double(rays.size());
+
+    // Histograms, owned here and written at the end
+    const bool addDirectory = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(false);
+    const double cm = dd4hep::cm;
+    TH2D x0_map("x0_map", "Radiation lengths;x [cm];y [cm];X/X_{0}",
+                cfg.nx, cfg.xmin/cm, cfg.xmax/cm, cfg.ny, cfg.ymin/cm, cfg.ymax/cm);
+    TH2D lambda_map("lambda_map", "Interaction lengths;x [cm];y [cm];X/#lambda_{I}",
+                    cfg.nx, cfg.xmin/cm, cfg.xmax/cm, cfg.ny, cfg.ymin/cm, cfg.ymax/cm);
+    for( int iy = 0; iy < cfg.ny; ++iy )
+      for( int ix = 0; ix < cfg.nx; ++ix )  {
+        const Budget& b = rays[std::size_t(iy)*cfg.nx + ix];
+        x0_map.SetBinContent(ix+1, iy+1, b.x0);
+        lambda_map.SetBinContent(ix+1, iy+1, b.lambda);
+      }
+    // One bin per layer, labelled subdetector/field:value
+    std::map<int, std::string> systems;
+    for( const auto& d : description.detectors() ) systems[DetElement(d.second).id()] = d.first;
+    std::map<LayerKey, std::string> layerName;
+    for( const auto& l : all.layers )  {
+      const LayerKey& k = l.first;
+      if ( k.outside() )  {
+        layerName[k] = "outside";
+        continue;
+      }
+      auto sys = systems.find(k.system);
+      std::stringstream name;
+      name << (sys != systems.end() ? sys->second : "system " + std::to_string(k.system))
+           << "/" << cfg.fields[k.field] << ":" << k.value;
+      layerName[k] = name.str();
+    }
+    const int nbins = std::max(1, int(all.layers.size()));
+    TH1D x0_layer("x0_layer", "Radiation lengths per layer;;X/X_{0}", nbins, 0, nbins);
+    TH1D lambda_layer("lambda_layer", "Interaction lengths per layer;;X/#lambda_{I}", nbins, 0, nbins);
+    TH1D x0_cum("x0_cumulative", "Cumulative radiation lengths;;X/X_{0}", nbins, 0, nbins);
+    TH1D lambda_cum("lambda_cumulative", "Cumulative interaction lengths;;X/#lambda_{I}", nbins, 0, nbins);
+    std::map<const TGeoMaterial*, Budget> byMaterial;
+    for( const auto& l : all.materials )
+      for( const auto& m : l.second ) byMaterial[m.first] += m.second;
+    const int nmat = int(byMaterial.size());
+    TH2D x0_mat("x0_layer_material", "Radiation lengths per layer and material;;;X/X_{0}",
+                nbins, 0, nbins, std::max(1, nmat), 0, std::max(1, nmat));
+    TH2D lambda_mat("lambda_layer_material", "Interaction lengths per layer and material;;;X/#lambda_{I}",
+                    nbins, 0, nbins, std::max(1, nmat), 0, std::max(1, nmat));
+    std::map<const TGeoMaterial*, int> matBin;
+    for( const auto& m : byMaterial )  {
+      const int bin = int(matBin.size()) + 1;
+      matBin[m.first] = bin;
+      x0_mat.GetYaxis()->SetBinLabel(bin, m.first->GetName());
+      lambda_mat.GetYaxis()->SetBinLabel(bin, m.first->GetName());
+    }
+
+    printout(ALWAYS, "DD4SHiP_MaterialBudget", "%d x %d rays, %d threads: %.3f s", cfg.nx, cfg.ny, nthreads, elapsed);
+    printout(ALWAYS, "DD4SHiP_MaterialBudget", "%-40s %10s %10s %10s %10s  %s", "layer", "X/X0", "sum X/X0",
+             "X/lI", "sum X/lI", "materials (X/X0)");
+    Budget cumulative;
+    int bin = 0;
+    for( const auto& l : all.layers )  {
+      const Budget mean { l.second.x0/nrays, l.second.lambda/nrays };
+      const char*  name = layerName[l.first].c_str();
+      ++bin;
+      cumulative += mean;
+      for( TH1* h : std::initializer_list<TH1*>{ &x0_layer, &lambda_layer, &x0_cum, &lambda_cum } )
+        h->GetXaxis()->SetBinLabel(bin, name);
+      x0_mat.GetXaxis()->SetBinLabel(bin, name);
+      lambda_mat.GetXaxis()->SetBinLabel(bin, name);
+      x0_layer.SetBinContent(bin, mean.x0);
+      lambda_layer.SetBinContent(bin, mean.lambda);
+      std::string mats;
+      for( const auto& m : all.materials[l.first] )  {
+        char txt[128];
+        ::snprintf(txt, sizeof(txt), " %s:%.4f", m.first->GetName(), m.second.x0/nrays);
+        mats += txt;
+        x0_mat.Fill(bin - 0.5, matBin[m.first] - 0.5, m.second.x0/nrays);
+        lambda_mat.Fill(bin - 0.5, matBin[m.first] - 0.5, m.second.lambda/nrays);
+      }
+      printout(ALWAYS, "DD4SHiP_MaterialBudget", "%-40s %10.4f %10.4f %10.5f %10.5f %s", name,
+               mean.x0, cumulative.x0, mean.lambda, cumulative.lambda, mats.c_str());
+    }
+    double cx0 = 0, clambda = 0;
+    for( int b = 1; b <= nbins; ++b )  {
+      cx0     += x0_layer.GetBinContent(b);
+      clambda += lambda_layer.GetBinContent(b);
+      x0_cum.SetBinContent(b, cx0);
+      lambda_cum.SetBinContent(b, clambda);
+    }
+    printout(ALWAYS, "DD4SHiP_MaterialBudget", "%-24s %12s %12s", "material", "X/X0", "X/lI");
+    for( const auto& m : byMaterial )
+      printout(ALWAYS, "DD4SHiP_MaterialBudget", "%-24s %12.4f %12.5f", m.first->GetName(),
+               m.second.x0/nrays, m.second.lambda/nrays);
+    if ( all.stuck > 0 )
+      printout(WARNING, "DD4SHiP_MaterialBudget", "%ld rays stopped after repeated zero steps.", all.stuck);
+    TH1::AddDirectory(addDirectory);
+    TFile out(cfg.output.c_str(), "RECREATE");
+    if ( out.IsZombie() ) except("DD4SHiP_MaterialBudget", "Cannot create %s", cfg.output.c_str());
+    for( TH1* h : std::initializer_list<TH1*>{ &x0_map, &lambda_map, &x0_layer, &lambda_layer, &x0_cum, &lambda_cum,
+                                              &x0_mat, &lambda_mat } )
+      h->Write();
+    out.Close();
+    printout(INFO, "DD4SHiP_MaterialBudget", "Maps and profiles written to %s", cfg.output.c_str());
+    return 1;
+  }
+}
+
+DECLARE_APPLY(DD4SHiP_MaterialBudget, material_budget)
@@ -0,0 +1,419 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Parallel, sampling based overlap check.
+//
+//   geoPluginRun -input SHiPCalo.xml -plugin DD4SHiP_OverlapCheck -threads 8
+//
+// Every logical volume is checked once, however often it is placed. In a
+// volume the daughters are grouped into regular runs (same volume and
+// rotation, constant translation step: the bars of a layer, the fibres of
+// an HPL layer). Of each run only the first and last -representatives
+// members are checked; the pairs in between repeat the same geometry.
+// Daughters outside runs are checked against everything they touch.
+//
+// A check samples -points random points in the intersection of the two
+// bounding boxes (pairs) or in the daughter (extrusion from the mother).
+// A point inside both daughters, or inside the daughter but outside the
+// mother, deeper than -tolerance counts as overlap; the deepest point is
+// reported with the volIDs of the placement path of the mother (first
+// placement found) and of the daughters, and the point in global
+// coordinates. The pairs are spread over the threads; the points of each
+// check depend only on -seed, not on the number of threads.
+//
+// Options (lengths accept units, e.g. -tolerance 1*um):
+//   -threads N           worker threads (0: hardware)    (0)
+//   -points N            points per check                (1000)
+//   -tolerance L         ignored depth                   (1 um)
+//   -representatives N   checked members at each end of a regular run (2)
+//   -full                check all members of regular runs
+//   -detector name       only the subtree of this subdetector
+//   -print N             overlaps printed, deepest first (50)
+//   -seed N              random seed                     (12345)
+//
+//==========================================================================
+#include <DD4hep/DetFactoryHelper.h>
+#include <DD4hep/Printout.h>
+#include <DD4hep/Volumes.h>
+
+#include <TGeoBBox.h>
+#include <TGeoManager.h>
+#include <TGeoMatrix.h>
+#include <TGeoNode.h>
+#include <TGeoVolume.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace dd4hep;
+
+namespace {
+
+  struct OverlapConfig  {
+    int      threads = 0;
+    int      points  = 1000;
+    double   tolerance = 1*dd4hep::um;
+    int      representatives = 2;
+    bool     full    = false;
+    std::string detector;
+    int      print   = 50;
+    unsigned seed    = 12345;
+  };
+
+  /// Daughter placement with its bounding box in the mother frame
+  struct Daughter  {
+    const TGeoNode* node;
+    double          lo[3], hi[3];
+    bool            checked = true;
+  };
+
+  /// Logical volume to check and the first placement path leading to it
+  struct VolumeInfo  {
+    const TGeoVolume*             volume;
+    std::vector<const TGeoNode*>  path;
+    std::vector<Daughter>         daughters;
+    long                          skipped = 0;   // members not checked in regular runs
+  };
+
+  /// One check: pair of daughters, or daughter against its mother (b < 0)
+  struct Check  {
+    const VolumeInfo* info;
+    int               a, b;
+  };
+
+  struct Overlap  {
+    const VolumeInfo* info;
+    int               a, b;
+    double            depth;
+    double            local[3];    // deepest point, mother frame
+  };
+
+  void boundingBox(const TGeoNode* node, double lo[3], double hi[3])  {
+    const TGeoBBox*   box = static_cast<const TGeoBBox*>(node->GetVolume()->GetShape());
+    const TGeoMatrix* mat = node->GetMatrix();
+    const double*     o   = box->GetOrigin();
+    const double      d[3] = { box->GetDX(), box->GetDY(), box->GetDZ() };
+    for( int k = 0; k < 3; ++k )  { lo[k] = 1e300; hi[k] = -1e300; }
+    for( int c = 0; c < 8; ++c )  {
+      const double local[3] = { o[0] + ((c & 1) ? d[0] : -d[0]),
+                                o[1] + ((c & 2) ? d[1] : -d[1]),
+                                o[2] + ((c & 4) ? d[2] : -d[2]) };
+      double master[3];
+      mat->LocalToMaster(local, master);
+      for( int k = 0; k < 3; ++k )  {
+        lo[k] = std::min(lo[k], master[k]);
+        hi[k] = std::max(hi[k], master[k]);
+      }
+    }
+  }
+
+  bool sameRotation(const TGeoMatrix* a, const TGeoMatrix* b)  {
+    const double* ra = a->GetRotationMatrix();
+    const double* rb = b->GetRotationMatrix();
+    for( int k = 0; k < 9; ++k ) if ( std::abs(ra[k] - rb[k]) > 1e-12 ) return false;
+    return true;
+  }
+
+  /// Mark the members between the representatives of each regular run as unchecked
+  void pruneRegularRuns(VolumeInfo& info, int reps)  {
+    auto& ds = info.daughters;
+    std::size_t first = 0;
+    while( first < ds.size() )  {
+      std::size_t last = first + 1;
+      double step[3] = { 0, 0, 0 };
+      if ( last < ds.size() )  {
+        const double* t0 = ds[first].node->GetMatrix()->GetTranslation();
+        const double* t1 = ds[last].node->GetMatrix()->GetTranslation();
+        for( int k = 0; k < 3; ++k ) step[k] = t1[k] - t0[k];
+      }
+      while( last < ds.size() &&
+             ds[last].node->GetVolume() == ds[first].node->GetVolume() &&
+             sameRotation(ds[last].node->GetMatrix(), ds[first].node->GetMatrix()) )  {
+        const double* tp = ds[last-1].node->GetMatrix()->GetTranslation();
+        const double* tl = ds[last].node->GetMatrix()->GetTranslation();
+        bool regular = true;
+        for( int k = 0; k < 3; ++k ) regular &= std::abs(tl[k] - tp[k] - step[k]) < 1e-9;
+        if ( !regular ) break;
+        ++last;
+      }
+      const std::size_t len = last - first;
+      if ( len > std::size_t(2*reps + 1) )  {
+        for( std::size_t i = first + reps; i < last - reps; ++i ) ds[i].checked = false;
+        info.skipped += len - 2*reps;
+      }
+      first = last;
+    }
+  }
+
+  bool touches(const Daughter& a, const Daughter& b, double tol)  {
+    for( int k = 0; k < 3; ++k )
+      if ( std::min(a.hi[k], b.hi[k]) - std::max(a.lo[k], b.lo[k]) <= tol ) return false;
+    return true;
+  }
+
+  /// Extrusion is impossible if the daughter box lies inside a box shaped mother
+  bool insideMotherBox(const TGeoVolume* mother, const Daughter& d, double tol)  {
+    const TGeoShape* shape = mother->GetShape();
+    if ( shape->IsA() != TGeoBBox::Class() ) return false;
+    const TGeoBBox* box = static_cast<const TGeoBBox*>(shape);
+    const double*   o   = box->GetOrigin();
+    const double    h[3] = { box->GetDX(), box->GetDY(), box->GetDZ() };
+    for( int k = 0; k < 3; ++k )
+      if ( d.lo[k] < o[k] - h[k] - tol || d.hi[k] > o[k] + h[k] + tol ) return false;
+    return true;
+  }
+
+  class OverlapSampler  {
+    const OverlapConfig& m_cfg;
+    std::mt19937_64      m_rndm;
+
+    double uniform(double lo, double hi)  {
+      return lo + (hi - lo)*std::generate_canonical<double, 53>(m_rndm);
+    }
+
+  public:
+    explicit OverlapSampler(const OverlapConfig& cfg) : m_cfg(cfg)  {}
+
+    /// Deepest overlap of one check, depth 0 if none
+    Overlap run(const Check& chk, std::size_t index)  {
+      m_rndm.seed(m_cfg.seed + 0x9e3779b97f4a7c15ULL*(index + 1));
+      Overlap result { chk.info, chk.a, chk.b, 0e0, { 0, 0, 0 } };
+      const Daughter&   da = chk.info->daughters[chk.a];
+      const TGeoShape*  sa = da.node->GetVolume()->GetShape();
+      const TGeoMatrix* ma = da.node->GetMatrix();
+      double pm[3], pa[3], pb[3];
+      if ( chk.b < 0 )  {
+        const TGeoShape* mother = chk.info->volume->GetShape();
+        const TGeoBBox*  box    = static_cast<const TGeoBBox*>(sa);
+        const double*    o      = box->GetOrigin();
+        const double     h[3]   = { box->GetDX(), box->GetDY(), box->GetDZ() };
+        for( int i = 0; i < m_cfg.points; ++i )  {
+          for( int k = 0; k < 3; ++k ) pa[k] = uniform(o[k] - h[k], o[k] + h[k]);
+          if ( !sa->Contains(pa) ) continue;
+          ma->LocalToMaster(pa, pm);
+          if ( mother->Contains(pm) ) continue;
+          const double depth = mother->Safety(pm, kFALSE);
+          if ( depth > result.depth )  {
+            result.depth = depth;
+            std::copy(pm, pm+3, result.local);
+          }
+        }
+        return result;
+      }
+      const Daughter&   db = chk.info->daughters[chk.b];
+      const TGeoShape*  sb = db.node->GetVolume()->GetShape();
+      const TGeoMatrix* mb = db.node->GetMatrix();
+      double lo[3], hi[3];
+      for( int k = 0; k < 3; ++k )  {
+        lo[k] = std::max(da.lo[k], db.lo[k]);
+        hi[k] = std::min(da.hi[k], db.hi[k]);
+      }
+      for( int i = 0; i < m_cfg.points; ++i )  {
+        for( int k = 0; k < 3; ++k ) pm[k] = uniform(lo[k], hi[k]);
+        ma->MasterToLocal(pm, pa);
+        if ( !sa->Contains(pa) ) continue;
+        mb->MasterToLocal(pm, pb);
+        if ( !sb->Contains(pb) ) continue;
+        const double depth = std::min(sa->Safety(pa, kTRUE), sb->Safety(pb, kTRUE));
+        if ( depth > result.depth )  {
+          result.depth = depth;
+          std::copy(pm, pm+3, result.local);
+        }
+      }
+      return result;
+    }
+  };
+
+  /// Walk the logical volumes once each, keeping the first path to every volume
+  void collectVolumes(const TGeoVolume* vol, std::vector<const TGeoNode*>& path,
+                      std::set<const TGeoVolume*>& seen, std::vector<VolumeInfo>& out)  {
+    if ( !seen.insert(vol).second ) return;
+    const int n = vol->GetNdaughters();
+    if ( n > 0 )  {
+      VolumeInfo info;
+      info.volume = vol;
+      info.path   = path;
+      info.daughters.reserve(n);
+      for( int i = 0; i < n; ++i )  {
+        Daughter d;
+        d.node = vol->GetNode(i);
+        boundingBox(d.node, d.lo, d.hi);
+        info.daughters.push_back(d);
+      }
+      out.push_back(std::move(info));
+    }
+    for( int i = 0; i < n; ++i )  {
+      const TGeoNode* node = vol->GetNode(i);
+      path.push_back(node);
+      collectVolumes(node->GetVolume(), path, seen, out);
+      path.pop_back();
+    }
+  }
+
+  /// First placement path from vol down to target, over each volume once
+  bool findPath(const TGeoVolume* vol, const TGeoVolume* target,
+                std::set<const TGeoVolume*>& seen, std::vector<const TGeoNode*>& path)  {
+    if ( vol == target ) return true;
+    if ( !seen.insert(vol).second ) return false;
+    for( int i = 0; i < vol->GetNdaughters(); ++i )  {
+      const TGeoNode* node = vol->GetNode(i);
+      path.push_back(node);
+      if ( findPath(node->GetVolume(), target, seen, path) ) return true;
+      path.pop_back();
+    }
+    return false;
+  }
+
+  std::string volIDs(const TGeoNode* node)  {
+    std::string txt;
+    try  {
+      for( const auto& id : PlacedVolume(const_cast<TGeoNode*>(node)).volIDs() )
+        txt += (txt.empty() ? "" : ",") + id.first + "=" + std::to_string(id.second);
+    }
+    catch(const std::exception&)  {
+      // node without DD4hep placement data
+    }
+    return txt;
+  }
+
+  std::string describe(const TGeoNode* node)  {
+    const std::string ids = volIDs(node);
+    return std::string(node->GetName()) + (ids.empty() ? "" : " [" + ids + "]");
+  }
+
+  long overlap_check(Detector& description, int argc, char** argv)  {
+    OverlapConfig cfg;
+    for( int i = 0; i < argc; ++i )  {
+      const char* a = argv[i];
+      const bool  more = i+1 < argc;
+      if      ( more && ::strcmp(a, "-threads") == 0 )         cfg.threads = ::atoi(argv[++i]);
+      else if ( more && ::strcmp(a, "-points") == 0 )          cfg.points = ::atoi(argv[++i]);
+      else if ( more && ::strcmp(a, "-tolerance") == 0 )       cfg.tolerance = _toDouble(argv[++i]);
+      else if ( more && ::strcmp(a, "-representatives") == 0 ) cfg.representatives = ::atoi(argv[++i]);
+      else if ( ::strcmp(a, "-full") == 0 )                    cfg.full = true;
+      else if ( more && ::strcmp(a, "-detector") == 0 )        cfg.detector = argv[++i];
+      else if ( more && ::strcmp(a, "-print") == 0 )           cfg.print = ::atoi(argv[++i]);
+      else if ( more && ::strcmp(a, "-seed") == 0 )            cfg.seed = unsigned(::atol(argv[++i]));
+      else except("DD4SHiP_OverlapCheck", "Unknown or incomplete option %s", a);
+    }
+    if ( cfg.points < 1 || cfg.representatives < 1 )
+      except("DD4SHiP_OverlapCheck", "Need at least one point and one representative.");
+    const int nthreads = cfg.threads > 0 ? cfg.threads : std::max(1u, std::thread::hardware_concurrency());
+    TGeoManager& mgr = description.manager();
+    if ( !mgr.IsClosed() ) mgr.CloseGeometry();
+
+    // Volumes, daughters and the list of checks
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<VolumeInfo>      volumes;
+    std::set<const TGeoVolume*>  seen;
+    std::vector<const TGeoNode*> path;
+    const TGeoVolume* top = mgr.GetTopVolume();
+    if ( !cfg.detector.empty() )  {
+      const TGeoVolume* det = description.detector(cfg.detector).placement().volume().ptr();
+      if ( !findPath(top, det, seen, path) )
+        except("DD4SHiP_OverlapCheck", "Subdetector %s is not placed.", cfg.detector.c_str());
+      seen.clear();
+      top = det;
+    }
+    collectVolumes(top, path, seen, volumes);
+
+    std::vector<Check> checks;
+    long daughters = 0, skipped = 0;
+    for( auto& info : volumes )  {
+      if ( !cfg.full ) pruneRegularRuns(info, cfg.representatives);
+      const auto& ds  = info.daughters;
+      const bool  assembly = info.volume->IsAssembly();
+      daughters += ds.size();
+      skipped   += info.skipped;
+      for( int a = 0; a < int(ds.size()); ++a )  {
+        if ( !ds[a].checked ) continue;
+        if ( !assembly && !insideMotherBox(info.volume, ds[a], cfg.tolerance) )
+          checks.push_back(Check { &info, a, -1 });
+        for( int b = 0; b < int(ds.size()); ++b )  {
+          if ( b == a || (ds[b].checked && b < a) ) continue;   // checked pairs once
+          if ( touches(ds[a], ds[b], cfg.tolerance) ) checks.push_back(Check { &info, a, b });
+        }
+      }
+    }
+    printout(INFO, "DD4SHiP_OverlapCheck", "%ld volumes, %ld daughters (%ld inside regular runs skipped), %ld checks",
+             long(volumes.size()), daughters, skipped, long(checks.size()));
+
+    // Run the checks, spread over the threads in chunks
+    mgr.SetMaxThreads(nthreads);
+    std::atomic<std::size_t>            next { 0 };
+    std::vector<std::vector<Overlap> >  found(nthreads);
+    std::vector<std::thread>            workers;
+    const std::size_t chunk = 64;
+    for( int t = 0; t < nthreads; ++t )  {
+      workers.emplace_back([&, t]()  {
+        TGeoNavigator* nav = mgr.GetCurrentNavigator();
+        if ( !nav ) nav = mgr.AddNavigator();
+        OverlapSampler sampler(cfg);
+        for( std::size_t begin = next.fetch_add(chunk); begin < checks.size(); begin = next.fetch_add(chunk) )  {
+          const std::size_t end = std::min(checks.size(), begin + chunk);
+          for( std::size_t i = begin; i < end; ++i )  {
+            Overlap ovl = sampler.run(checks[i], i);
+            if ( ovl.depth > cfg.tolerance ) found[t].push_back(ovl);
+          }
+        }
+        mgr.RemoveNavigator(nav);
+      });
+    }
+    for( auto& w : workers ) w.join();
+    mgr.SetMaxThreads(0);
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<Overlap> overlaps;
+    for( const auto& f : found ) overlaps.insert(overlaps.end(), f.begin(), f.end());
+    std::sort(overlaps.begin(), overlaps.end(), [](const Overlap& a, const Overlap& b) { return a.depth > b.depth; });
+
+    const double mm = dd4hep::mm;
+    for( std::size_t i = 0; i < overlaps.size() && int(i) < cfg.print; ++i )  {
+      const Overlap& o = overlaps[i];
+      TGeoHMatrix global;
+      std::string where;
+      for( const TGeoNode* node : o.info->path )  {
+        global.Multiply(node->GetMatrix());
+        const std::string ids = volIDs(node);
+        if ( !ids.empty() ) where += (where.empty() ? "" : ",") + ids;
+      }
+      double pg[3];
+      global.LocalToMaster(o.local, pg);
+      const Daughter& da = o.info->daughters[o.a];
+      std::stringstream msg;
+      msg << (o.b < 0 ? "Extrusion " : "Overlap ") << o.depth/mm << " mm in " << o.info->volume->GetName();
+      if ( !where.empty() ) msg << " [" << where << "]";
+      msg << ": " << describe(da.node);
+      if ( o.b < 0 ) msg << " sticks out of the mother";
+      else           msg << " and " << describe(o.info->daughters[o.b].node);
+      msg << " at (" << pg[0]/mm << ", " << pg[1]/mm << ", " << pg[2]/mm << ") mm";
+      printout(ERROR, "DD4SHiP_OverlapCheck", "%s", msg.str().c_str());
+    }
+    if ( int(overlaps.size()) > cfg.print )
+      printout(ERROR, "DD4SHiP_OverlapCheck", "... %ld more", long(overlaps.size()) - cfg.print);
+    printout(overlaps.empty() ? INFO : ERROR, "DD4SHiP_OverlapCheck",
+             "%ld overlaps deeper than %g mm, %ld checks x %d points, %d threads: %.3f s",
+             long(overlaps.size()), cfg.tolerance/mm, long(checks.size()), cfg.points, nthreads, elapsed);
+    return 1;
+  }
+}
+
+DECLARE_APPLY(DD4SHiP_OverlapCheck, overlap_check)
@@ -89,12 +89,12 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
     if(iz%2 == 0){
     	double z = -box.z() + (double(iz)+0.5) * (2.0*tol + delta);
     	PlacedVolume pv = box_vol.placeVolume(big_layer_vol, Position(0e0, 0e0, z));
-    	pv.addPhysVolID("big_layer", iz);
+    	pv.addPhysVolID("layer", iz);
     }
     else{
     	double z = -box.z() + (double(iz)+0.5) * (2.0*tol + delta);
     	PlacedVolume pv = box_vol.placeVolume(small_layer_vol, Position(0e0, 0e0, z));
-    	pv.addPhysVolID("small_layer", iz);
+    	pv.addPhysVolID("layer", iz);
     }
   }
   printout(INFO, "SHiP_HPL_Fibre_Trackers", "%s: Created %d layers of %d fibres each.", nam.c_str(), num_z, num_x);
@@ -13,6 +13,7 @@
 #include <DD4hep/DetFactoryHelper.h>
 #include <DD4hep/DD4hepUnits.h>
 #include <DD4hep/Printout.h>
+#include <DD4SHiP/LevelOfDetail.h>
 #include <iostream>
 using namespace dd4hep;
 
@@ -48,6 +49,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   const int    hplnum_x_small = hplnum_x - 1;
 //  const int    num_z   = int(2e0*x_box.z() / (delta+2*tol));
   const double hplnum_z   =  x_det.attr<int>(_Unicode(hpln_fibre_layers));
+  const bool   coarse     =  dd4ship::levelOfDetail(x_det) == dd4ship::LOD_COARSE;
   
   
   //HPL definition
@@ -62,8 +64,23 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
 
   hpl_fibre_vol.placeVolume(hpl_fibre_core_vol);
 
+  //Coarse LOD: the HPL box becomes one slab with the mass of its fibres
+  Material hplbox_mat = description.air();
+  if( coarse )  {
+    const int    nbig   = (static_cast<int>(hplnum_z)+1)/2;
+    const int    nsmall = static_cast<int>(hplnum_z)/2;
+    const double nfibre = double(nbig*hplnum_x + nsmall*hplnum_x_small);
+    const double rcore  = x_hplfibre.rmax()-hpl_fibrethick;
+    const double vbox   = x_hplbox.x()*x_hplbox.y()*x_hplbox.z();
+    const double fcore  = nfibre*M_PI*rcore*rcore*x_hplfibre.y()/vbox;
+    const double fclad  = nfibre*M_PI*(x_hplfibre.rmax()*x_hplfibre.rmax()-rcore*rcore)*x_hplfibre.y()/vbox;
+    hplbox_mat = dd4ship::homogenisedMaterial(description, nam+"_hpl_lod",
+                                              { {description.material(x_hplcore.materialStr()),  fcore},
+                                                {description.material(x_hplfibre.materialStr()), fclad},
+                                                {description.air(), 1e0-fcore-fclad} });
+  }
   Box    hplbox((x_hplbox.x()-tol)/2., (x_hplbox.y()-tol)/2., (x_hplbox.z()-tol)/2.);
-  Volume hplbox_vol(nam, hplbox, description.air());
+  Volume hplbox_vol(nam, hplbox, hplbox_mat);
   hplbox_vol.setAttributes(description, x_hplbox.regionStr(), x_hplbox.limitsStr(), x_hplbox.visStr());
 
 
@@ -80,6 +97,11 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   
 
     hpl_fibre_core_vol.setSensitiveDetector(sens);
+  if( coarse )  {
+    //Layer granularity: the HPL box itself is the sensitive volume
+    hplbox_vol.setSensitiveDetector(sens);
+    printout(INFO, "SplitCal", "%s: lod=coarse, HPL fibres replaced by homogenised slabs.", nam.c_str());
+  }
 
   //Volume encoding
   //long DetectorCode = 9 * 1e15; 
@@ -105,14 +127,14 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
  //Build HPL layers
  
   Rotation3D hplrot(RotationZYX(0e0, 0e0, M_PI/2e0));
-  for( int ix=0; ix < hplnum_x; ++ix )  {
+  for( int ix=0; !coarse && ix < hplnum_x; ++ix )  {
     double x = -hplbox.x() + (double(ix)+0.5) * (hpldelta + 2e0*tol);
     PlacedVolume hplpv = hplbig_layer_vol.placeVolume(hpl_fibre_vol, Transform3D(hplrot,Position(x, 0e0, 0e0)));
     hplpv.addPhysVolID("splitcal_hplfibre", hplvolumecode);
     hplvolumecode++;
   }
 
-  for( int ix=0; ix < hplnum_x_small; ++ix )  {
+  for( int ix=0; !coarse && ix < hplnum_x_small; ++ix )  {
     double x = -hplbox.x() + (double(ix)+0.5) * (hpldelta + 2e0*tol) + x_hplfibre.rmax();
     PlacedVolume hplpv = hplsmall_layer_vol.placeVolume(hpl_fibre_vol, Transform3D(hplrot,Position(x, 0e0, 0e0)));
     hplpv.addPhysVolID("splitcal_hplfibre", hplvolumecode);
@@ -121,7 +143,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
 
 //Build the HPL Module
 
-  for( int iz=0; iz < hplnum_z; ++iz )  {
+  for( int iz=0; !coarse && iz < hplnum_z; ++iz )  {
     // leave 'tol' space between the layers
     if(iz%2 == 0){
         double z = -hplbox.z() + (double(iz)+0.5) * (2.0*tol + hpldelta);
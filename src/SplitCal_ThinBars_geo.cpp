@@ -13,6 +13,7 @@
 #include <DD4hep/DetFactoryHelper.h>
 #include <DD4hep/DD4hepUnits.h>
 #include <DD4hep/Printout.h>
+#include <DD4SHiP/LevelOfDetail.h>
 #include <iostream>
 using namespace dd4hep;
 
@@ -37,6 +38,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   const std::string calo_layer_codes = x_det.attr<std::string>(_Unicode(layer_codes));
   const int num_z   =  static_cast<unsigned>(calo_layer_codes.size()); 
   const int thinbar_num_x   =  x_thinbar.attr<unsigned>(_Unicode(num_x));
+  const bool coarse   =  dd4ship::levelOfDetail(x_det) == dd4ship::LOD_COARSE;
 
   //HPL fibre feature extraction 
   xml_dim_t    x_hplbox   = x_det.child(_Unicode(hplbox));
@@ -66,7 +68,13 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   double thinlayerwidth = x_thinbar.x() * static_cast<double>(thinbar_num_x);
 
   Box    det_thin_layerbox((thinlayerwidth+tol)/2., (x_thinbar.y()+tol)/2., (x_thinbar.z()+tol)/2.);
-  Volume det_thin_layerbox_vol("det_thin_layerbox", det_thin_layerbox, description.air());
+  //Coarse LOD: the layer becomes one slab of bar material, diluted by the
+  //x_extra_spacing gaps: bar width over bar pitch
+  Material thin_layer_mat = coarse
+    ? dd4ship::barLayerMaterial(description, nam+"_thinlayer_lod", description.material(x_thinbar.materialStr()),
+                                x_thinbar.x()/(x_thinbar.x()+thinbar_x_spacing))
+    : description.air();
+  Volume det_thin_layerbox_vol("det_thin_layerbox", det_thin_layerbox, thin_layer_mat);
   det_thin_layerbox_vol.setAttributes(description, x_detbox.regionStr(), x_detbox.limitsStr(), x_detbox.visStr());
   det_thin_layerbox_vol.setVisAttributes(description.visAttributes(x_detbox.visStr()));
   
@@ -94,7 +102,12 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   //Thin bar layers
   int volumecode = 0;
   double xpos = -(thinlayerwidth+tol)/2.;
-  for( int ix=0; ix < thinbar_num_x; ++ix )  {
+  if( coarse )  {
+    //Layer granularity: the slab itself is the sensitive volume
+    det_thin_layerbox_vol.setSensitiveDetector(sens);
+    printout(INFO, "SplitCal", "%s: lod=coarse, thin bars replaced by homogenised layer slabs.", nam.c_str());
+  }
+  for( int ix=0; !coarse && ix < thinbar_num_x; ++ix )  {
     xpos += x_thinbar.x()/2.; 
     PlacedVolume pv = det_thin_layerbox_vol.placeVolume(thinbar_vol, Transform3D(rot,Position(xpos, 0e0, 0e0)));
     pv.addPhysVolID("splitcal_bar", volumecode);
@@ -13,6 +13,7 @@
 #include <DD4hep/DetFactoryHelper.h>
 #include <DD4hep/DD4hepUnits.h>
 #include <DD4hep/Printout.h>
+#include <DD4SHiP/LevelOfDetail.h>
 #include <iostream>
 using namespace dd4hep;
 
@@ -37,6 +38,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   const std::string calo_layer_codes = x_det.attr<std::string>(_Unicode(layer_codes));
   const int num_z   =  static_cast<unsigned>(calo_layer_codes.size()); 
   const int widebar_num_x   =  x_widebar.attr<unsigned>(_Unicode(num_x));
+  const bool coarse   =  dd4ship::levelOfDetail(x_det) == dd4ship::LOD_COARSE;
 
   //HPL fibre feature extraction 
   xml_dim_t    x_hplbox   = x_det.child(_Unicode(hplbox));
@@ -68,7 +70,13 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
 	
   double wideboxwidth = x_widebar.x()*static_cast<double>(widebar_num_x);
   Box    det_wide_layerbox((wideboxwidth+tol)/2., (x_widebar.y()+tol)/2., (x_widebar.z()+tol)/2.);
-  Volume det_wide_layerbox_vol("det_wide_layerbox", det_wide_layerbox, description.air());
+  //Coarse LOD: the layer becomes one slab of bar material, diluted by the
+  //x_extra_spacing gaps: bar width over bar pitch
+  Material wide_layer_mat = coarse
+    ? dd4ship::barLayerMaterial(description, nam+"_widelayer_lod", description.material(x_widebar.materialStr()),
+                                x_widebar.x()/(x_widebar.x()+widebar_x_spacing))
+    : description.air();
+  Volume det_wide_layerbox_vol("det_wide_layerbox", det_wide_layerbox, wide_layer_mat);
   det_wide_layerbox_vol.setAttributes(description, x_detbox.regionStr(), x_detbox.limitsStr(), x_detbox.visStr());
   det_wide_layerbox_vol.setVisAttributes(description.visAttributes(x_detbox.visStr()));
   
@@ -84,7 +92,12 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   //Build Wide bar layers
   double xpos = -(wideboxwidth+tol)/2.;
   int volumecode = 0;
-  for( int ix=0; ix < widebar_num_x; ++ix )  {
+  if( coarse )  {
+    //Layer granularity: the slab itself is the sensitive volume
+    det_wide_layerbox_vol.setSensitiveDetector(sens);
+    printout(INFO, "SplitCal", "%s: lod=coarse, wide bars replaced by homogenised layer slabs.", nam.c_str());
+  }
+  for( int ix=0; !coarse && ix < widebar_num_x; ++ix )  {
  
     xpos += x_widebar.x()/2.;
     PlacedVolume pv = det_wide_layerbox_vol.placeVolume(widebar_vol, Transform3D(rot,Position(xpos, 0e0, 0e0)));
@@ -13,6 +13,7 @@
 #include <DD4hep/DetFactoryHelper.h>
 #include <DD4hep/DD4hepUnits.h>
 #include <DD4hep/Printout.h>
+#include <DD4SHiP/LevelOfDetail.h>
 #include <iostream>
 using namespace dd4hep;
 
@@ -48,6 +49,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   const int    hplnum_x_small = hplnum_x - 1;
 //  const int    num_z   = int(2e0*x_box.z() / (delta+2*tol));
   const double hplnum_z   =  x_det.attr<int>(_Unicode(hpln_fibre_layers));
+  const bool   coarse     = dd4ship::levelOfDetail(x_det) == dd4ship::LOD_COARSE;
   
   
   //Bar definition
@@ -76,8 +78,23 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
 
   hpl_fibre_vol.placeVolume(hpl_fibre_core_vol);
 
+  //Coarse LOD: the HPL box becomes one slab with the mass of its fibres
+  Material hplbox_mat = description.air();
+  if( coarse )  {
+    const int    nbig   = (static_cast<int>(hplnum_z)+1)/2;
+    const int    nsmall = static_cast<int>(hplnum_z)/2;
+    const double nfibre = double(nbig*hplnum_x + nsmall*hplnum_x_small);
+    const double rcore  = x_hplfibre.rmax()-hpl_fibrethick;
+    const double vbox   = x_hplbox.x()*x_hplbox.y()*x_hplbox.z();
+    const double fcore  = nfibre*M_PI*rcore*rcore*x_hplfibre.y()/vbox;
+    const double fclad  = nfibre*M_PI*(x_hplfibre.rmax()*x_hplfibre.rmax()-rcore*rcore)*x_hplfibre.y()/vbox;
+    hplbox_mat = dd4ship::homogenisedMaterial(description, nam+"_hpl_lod",
+                                              { {description.material(x_hplcore.materialStr()),  fcore},
+                                                {description.material(x_hplfibre.materialStr()), fclad},
+                                                {description.air(), 1e0-fcore-fclad} });
+  }
   Box    hplbox((x_hplbox.x()-tol)/2., (x_hplbox.y()-tol)/2., (x_hplbox.z()-tol)/2.);
-  Volume hplbox_vol(nam, hplbox, description.air());
+  Volume hplbox_vol(nam, hplbox, hplbox_mat);
   hplbox_vol.setAttributes(description, x_hplbox.regionStr(), x_hplbox.limitsStr(), x_hplbox.visStr());
 
 
@@ -94,13 +111,23 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   
 //  box_vol.setVisAttributes(description.visAttributes(""));
 
+  //Coarse LOD: bar layers become slabs of bar material diluted by the gaps
+  Material wide_layer_mat = description.air();
+  Material thin_layer_mat = description.air();
+  if( coarse )  {
+    wide_layer_mat = dd4ship::barLayerMaterial(description, nam+"_widelayer_lod", description.material(x_widebar.materialStr()),
+                                               widebar_num_x*x_widebar.x()/x_detbox.x());
+    thin_layer_mat = dd4ship::barLayerMaterial(description, nam+"_thinlayer_lod", description.material(x_thinbar.materialStr()),
+                                               thinbar_num_x*x_thinbar.x()/x_detbox.x());
+  }
+
   Box    det_wide_layerbox((x_detbox.x()+tol)/2., (x_detbox.y()+tol)/2., (x_widebar.z()+tol)/2.);
-  Volume det_wide_layerbox_vol("det_wide_layerbox", det_wide_layerbox, description.air());
+  Volume det_wide_layerbox_vol("det_wide_layerbox", det_wide_layerbox, wide_layer_mat);
   det_wide_layerbox_vol.setAttributes(description, x_detbox.regionStr(), x_detbox.limitsStr(), x_detbox.visStr());
   det_wide_layerbox_vol.setVisAttributes(description.visAttributes(x_detbox.visStr()));
   
-  Box    det_thin_layerbox((x_detbox.x()+tol)/2., (x_detbox.y()+tol)/2., (x_widebar.z()+tol)/2.);
-  Volume det_thin_layerbox_vol("det_thin_layerbox", det_thin_layerbox, description.air());
+  Box    det_thin_layerbox((x_detbox.x()+tol)/2., (x_detbox.y()+tol)/2., (x_thinbar.z()+tol)/2.);
+  Volume det_thin_layerbox_vol("det_thin_layerbox", det_thin_layerbox, thin_layer_mat);
   det_thin_layerbox_vol.setAttributes(description, x_detbox.regionStr(), x_detbox.limitsStr(), x_detbox.visStr());
   det_thin_layerbox_vol.setVisAttributes(description.visAttributes(x_detbox.visStr()));
   
@@ -132,10 +159,18 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
 //  int DetectorCode = 9 * 1e8; 
 //  int ECALCode = 1 * 1e7;
 
+  if( coarse )  {
+    //Layer granularity: the slabs themselves are the sensitive volumes
+    det_wide_layerbox_vol.setSensitiveDetector(sens);
+    det_thin_layerbox_vol.setSensitiveDetector(sens);
+    hplbox_vol.setSensitiveDetector(sens);
+    printout(INFO, "SplitCal", "%s: lod=coarse, bars and fibres replaced by homogenised layer slabs.", nam.c_str());
+  }
+
   //Build Wide bar layers
   double xpos = -x_detbox.x()/2.;
   int volumecode = 0;
-  for( int ix=0; ix < widebar_num_x; ++ix )  {
+  for( int ix=0; !coarse && ix < widebar_num_x; ++ix )  {
  
     xpos += x_widebar.x()/2.;
     PlacedVolume pv = det_wide_layerbox_vol.placeVolume(widebar_vol, Transform3D(rot,Position(xpos, 0e0, 0e0)));
@@ -145,7 +180,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
   }
   xpos = -x_detbox.x()/2.;
   //Thin bar layers
-  for( int ix=0; ix < thinbar_num_x; ++ix )  {
+  for( int ix=0; !coarse && ix < thinbar_num_x; ++ix )  {
     xpos += x_thinbar.x()/2.; 
     PlacedVolume pv = det_thin_layerbox_vol.placeVolume(thinbar_vol, Transform3D(rot,Position(xpos, 0e0, 0e0)));
     pv.addPhysVolID("splitcal_bar", volumecode);
@@ -172,14 +207,14 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
  //Build HPL layers
  
   Rotation3D hplrot(RotationZYX(0e0, 0e0, M_PI/2e0));
-  for( int ix=0; ix < hplnum_x; ++ix )  {
+  for( int ix=0; !coarse && ix < hplnum_x; ++ix )  {
     double x = -hplbox.x() + (double(ix)+0.5) * (hpldelta + 2e0*tol);
     PlacedVolume hplpv = hplbig_layer_vol.placeVolume(hpl_fibre_vol, Transform3D(hplrot,Position(x, 0e0, 0e0)));
     hplpv.addPhysVolID("splitcal_hplfibre", hplvolumecode);
     hplvolumecode++;
   }
 
-  for( int ix=0; ix < hplnum_x_small; ++ix )  {
+  for( int ix=0; !coarse && ix < hplnum_x_small; ++ix )  {
     double x = -hplbox.x() + (double(ix)+0.5) * (hpldelta + 2e0*tol) + x_hplfibre.rmax();
     PlacedVolume hplpv = hplsmall_layer_vol.placeVolume(hpl_fibre_vol, Transform3D(hplrot,Position(x, 0e0, 0e0)));
     hplpv.addPhysVolID("splitcal_hplfibre", hplvolumecode);
@@ -188,7 +223,7 @@ static Ref_t create_detector(Detector& description, xml_h e, SensitiveDetector s
 
 //Build the HPL Module
 
-  for( int iz=0; iz < hplnum_z; ++iz )  {
+  for( int iz=0; !coarse && iz < hplnum_z; ++iz )  {
     // leave 'tol' space between the layers
     if(iz%2 == 0){
         double z = -hplbox.z() + (double(iz)+0.5) * (2.0*tol + hpldelta);
@@ -1,5 +1,6 @@
+import os
 from DDSim.DD4hepSimulation import DD4hepSimulation
-from g4units import mm, GeV, MeV
+from g4units import mm, ns, GeV, MeV
 SIM = DD4hepSimulation()
 
 ## The compact XML file, or multiple compact files, if the last one is the closer.
@@ -70,6 +71,12 @@ SIM.vertexSigma = [0.0, 0.0, 0.0, 0.0]
 ################################################################################
 
 ##  set the default calorimeter action 
+##  
+##  With enableDetailedShowerMode, bound the MC truth per hit to the 10 largest contributions
+##  (merged per particle and 1 ns time bin) plus one remainder entry, flagged by a negative length:
+##  
+##  >>> SIM.action.calo = ("DD4SHiPCompactCalorimeterAction", {"MaxContributions": 10, "TimeBin": 1*ns})
+##  
 SIM.action.calo = "Geant4ScintillatorCalorimeterAction"
 
 ## List of patterns matching sensitive detectors of type Calorimeter.
@@ -81,6 +88,10 @@ SIM.action.calorimeterSDTypes = ['calorimeter']
 ## 
 ##       SIM.action.mapActions['tpc'] = "TPCSDAction"
 ##     
+##     Expected photoelectrons at both bar ends (Birks saturation, tabulated attenuation) stored with the hits:
+## 
+##       SIM.action.mapActions['SplitCal'] = ("DD4SHiPScintillatorLightAction", {"LightYield": 15/MeV, "AttenuationLength": 3500*mm})
+##     
 SIM.action.mapActions = {}
 
 ##  set the default tracker action 
@@ -89,6 +100,58 @@ SIM.action.tracker = ('Geant4TrackerWeightedAction', {'HitPositionCombination':
 ## List of patterns matching sensitive detectors of type Tracker.
 SIM.action.trackerSDTypes = ['tracker']
 
+## Additional event actions (DD4SHiP actions live in libDD4SHIPG4).
+## 
+##   Stream hit summaries to shared memory for the live monitor scripts/monitorHits.C
+## 
+##   >>> SIM.action.event = [ {"name": "DD4SHiPHitStream/HitStream", "parameter": {"SegmentName": "/dd4ship_hits"}} ]
+## 
+##   Fill the readHits_Full.C histograms and per-layer energy sums during the run
+## 
+##   >>> SIM.action.event = [ {"name": "DD4SHiPDQMHistograms/DQM", "parameter": {"Output": "dqm.root"}} ]
+## 
+##   and, to skip writing the hit collections altogether, install an empty output plugin
+## 
+##   >>> def noOutput(dd4hepSimulation): pass
+##   >>> SIM.outputConfig.userOutputPlugin = noOutput
+## 
+##   Checkpoint long sequential jobs: flush the output and log the engine state every 100 events
+## 
+##   >>> SIM.action.event = [ {"name": "DD4SHiPCheckpoint/Checkpoint", "parameter": {"Checkpoint": "job.ckpt", "Interval": 100}} ]
+## 
+##   and after an interruption rerun the same command with a new --outputFile and
+## 
+##   >>>                        "parameter": {"Checkpoint": "job.ckpt", "ResumeFile": "interrupted_output.root"}
+## 
+SIM.action.event = []
+
+## Step profiler (libDD4SHIPG4): steps and time per logical volume and particle, sorted report at end of run
+## 
+##   >>> SIM.action.step = [ {"name": "DD4SHiPStepProfiler/Profiler", "parameter": {"Output": "step_profile.csv"}} ]
+## 
+
+## Killing of slow neutrons and late tracks (libDD4SHIPG4): tracks later than TimeCut, neutrons below the
+## threshold of their volume (innermost match of logical volume or region name), and Russian roulette with
+## weights below RouletteEnergy (only with DD4SHiPCompactCalorimeterAction or DD4SHiPScintillatorLightAction,
+## which apply the track weight). Enable here or with DD4SHIP_TRACKKILLER=1 in the environment.
+DD4SHiPTrackKiller = os.environ.get("DD4SHIP_TRACKKILLER", "0") == "1"
+DD4SHiPTrackKillerParameters = {"TimeCut": 500*ns,
+                                "Thresholds": {"passive_layer": 1*MeV, "split": 1*MeV},
+                                "RouletteEnergy": 0., "SurvivalProbability": 1.}
+
+if DD4SHiPTrackKiller:
+  SIM.action.stack = [ {"name": "DD4SHiPTrackKillerStack/TrackKillerStack", "parameter": DD4SHiPTrackKillerParameters} ]
+  SIM.action.step = [ {"name": "DD4SHiPTrackKiller/TrackKiller", "parameter": DD4SHiPTrackKillerParameters} ]
+
+## Energy in the absorbers per layer without sensitive lead (libDD4SHIPG4): one float per passive_layer and split
+## layer and event, written to the tree ABSORBER of Output. Enable here or with DD4SHIP_ABSORBER_ENERGY=1.
+##   >>> ABSORBER->BuildIndex("event"); EVENT->SetAlias("event", "Entry$"); EVENT->AddFriend(ABSORBER)
+DD4SHiPAbsorberEnergy = os.environ.get("DD4SHIP_ABSORBER_ENERGY", "0") == "1"
+
+if DD4SHiPAbsorberEnergy:
+  SIM.action.step = list(SIM.action.step) + [ {"name": "DD4SHiPAbsorberEnergy/AbsorberEnergy",
+                                               "parameter": {"Output": "absorber_energy.root"}} ]
+
 
 ################################################################################
 ## Configuration for the magnetic field (stepper) 
@@ -257,6 +320,26 @@ SIM.hepmc3.useHepMC3 = True
 ##     
 SIM.inputConfig.userInputPlugin = []
 
+## HepMC3 input read on a prefetch thread (libDD4SHIPG4, needs HepMC3): events are parsed, decompressed
+## (.gz, .bz2, .xz, .zst) and converted ahead of the simulation, which only takes them from a queue.
+## Set the file here or with DD4SHIP_PREFETCH_HEPMC3=<file> in the environment, and leave SIM.inputFiles empty.
+DD4SHiPPrefetchHepMC3 = os.environ.get("DD4SHIP_PREFETCH_HEPMC3", "")
+
+
+def prefetchHepMC3(dd4hepSimulation):
+  from DDG4 import GeneratorAction, Kernel
+  dd = dd4hepSimulation
+  gen = GeneratorAction(Kernel(), 'Geant4InputAction/PrefetchHepMC3', True)
+  gen.Input = 'DD4SHiPHepMC3PrefetchReader|' + DD4SHiPPrefetchHepMC3
+  gen.Parameters = {'QueueDepth': '8', 'PrintLatency': '0', 'Flow1': dd.hepmc3.Flow1, 'Flow2': dd.hepmc3.Flow2}
+  gen.OutputLevel = dd.output.inputStage
+  gen.enableUI()
+  return gen
+
+
+if DD4SHiPPrefetchHepMC3:
+  SIM.inputConfig.userInputPlugin = [prefetchHepMC3]
+
 
 ################################################################################
 ## Configuration for the generator-level InputFiles 
@@ -334,6 +417,27 @@ SIM.output.physics = 0
 ##     
 SIM.outputConfig.userOutputPlugin = None
 
+## ROOT output written on a separate thread (libDD4SHIPG4, sequential runs): the simulation thread only
+## copies the hits of each event, serialisation and compression overlap with the next event.
+## Enable here or with DD4SHIP_ASYNC_OUTPUT=1 in the environment.
+DD4SHiPAsyncOutput = os.environ.get("DD4SHIP_ASYNC_OUTPUT", "0") == "1"
+
+
+def asyncOutput(dd4hepSimulation):
+  from DDG4 import EventAction, Kernel
+  dd = dd4hepSimulation
+  evt_root = EventAction(Kernel(), 'DD4SHiPAsyncOutput2ROOT/' + dd.outputFile, True)
+  evt_root.HandleMCTruth = True
+  evt_root.QueueDepth = 2
+  evt_root.Output = dd.outputFile if dd.outputFile.endswith('.root') else dd.outputFile + '.root'
+  evt_root.enableUI()
+  Kernel().eventAction().add(evt_root)
+  return None
+
+
+if DD4SHiPAsyncOutput:
+  SIM.outputConfig.userOutputPlugin = asyncOutput
+
 
 ################################################################################
 ## Configuration for the Particle Handler/ MCTruth treatment 
@@ -363,6 +467,12 @@ SIM.part.printStartTracking = False
 SIM.part.saveProcesses = ['Decay']
 
 ## Optionally enable an extended Particle Handler
+## 
+##   Keep only primaries, particles entering SplitCal/HCAL and decay products above 100 MeV;
+##   hits of in-shower secondaries go to the particle that entered the calorimeter:
+## 
+##   >>> SIM.part.userParticleHandler = "DD4SHiPCaloParticleHandler"
+## 
 SIM.part.userParticleHandler = ""
 
 
@@ -377,6 +487,10 @@ SIM.part.userParticleHandler = ""
 SIM.physics.decays = False
 
 ## The name of the Geant4 Physics list.
+## 
+##     "DD4SHiP_EM" selects the EM-only list of libDD4SHIPG4 (standard EM + decays, no hadronic physics),
+##     e.g. for photon/electron SplitCal studies:  ddsim ... --physics.list DD4SHiP_EM
+##     
 SIM.physics.list = "FTFP_BERT"
 
 ##  location of particle.tbl file containing extra particles and their lifetime information
@@ -408,6 +522,40 @@ SIM.physics.rejectPDGs = {1, 2, 3, 4, 5, 6, 3201, 3203, 4101, 4103, 21, 23, 24,
 ##     
 SIM.physics.zeroTimePDGs = {17, 11, 13, 15}
 
+## Replace the reference list by the DD4SHiP EM-only list when --physics.list DD4SHiP_EM is given.
+## EMOption selects G4EmStandardPhysics (0) or G4EmStandardPhysics_optionN (1-4).
+## Both are done in setupDD4SHiPPhysics below, which also adds the fast muon transport.
+
+## Opt-in fast muon transport (libDD4SHIPG4): muons above FastMuonMinEnergy entering
+## the calorimeter envelopes are moved straight through, with Landau sampled deposits in
+## the sensitive bars; catastrophic losses are sampled along the path and their secondaries
+## handed to full simulation (tests/physics/fastMuonCatastrophic.py compares the rates).
+## Enable here or with DD4SHIP_FASTMUONS=1 in the environment.
+DD4SHiPFastMuons = os.environ.get("DD4SHIP_FASTMUONS", "0") == "1"
+DD4SHiPFastMuonMinEnergy = 5*GeV
+
+
+def setupDD4SHiPPhysics(kernel):
+  from DDG4 import PhysicsList, DetectorConstruction
+  seq = kernel.physicsList()
+  if DD4SHiPFastMuons:
+    fastPhysics = PhysicsList(kernel, 'DD4SHiPFastMuonPhysics/FastMuonPhysics')
+    seq.adopt(fastPhysics)
+    model = DetectorConstruction(kernel, 'DD4SHiPFastMuonModel/FastMuonModel')
+    model.Envelopes = ["SplitCalTest_Base_and_wide_bars", "HCAL_module"]
+    model.MinEnergy = DD4SHiPFastMuonMinEnergy
+    model.CatastrophicFraction = 0.01
+    kernel.detectorConstruction(True).adopt(model)
+  if seq.extends != "DD4SHiP_EM":
+    return
+  seq.extends = ""
+  emPhysics = PhysicsList(kernel, 'DD4SHiPEMOnlyPhysics/EMOnlyPhysics')
+  emPhysics.EMOption = 0
+  emPhysics.enableUI()
+  seq.adopt(emPhysics)
+
+SIM.physics.setupUserPhysics(setupDD4SHiPPhysics)
+
 
 ################################################################################
 ## Properties for the random number generator 
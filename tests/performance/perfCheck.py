@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Performance regression checks run by ctest (ctest -L performance).
+
+    perfCheck.py geometry SHiPCalo.xml --baseline baseline.json
+    perfCheck.py geometry SHiPCalo.xml --counts --baseline baseline.json
+    perfCheck.py simulation --particle pi- --energy 30 -N 10 --compactFile SHiPCalo.xml --baseline baseline.json
+
+geometry:   builds the compact file in a fresh process (best of --repeat) and
+            counts the physical nodes and logical volumes of the TGeo tree;
+            with --counts only the counts are checked, from one build.
+simulation: runs ddsim with a fixed seed for 1 and N events; the difference
+            gives the event rate, the N-event run the peak RSS.
+
+Each measurement is compared with its entry in the baseline file, within the
+relative tolerances stored there; node and volume counts must match exactly,
+and a missing count in the baseline is a failure.
+Exit codes: 0 pass, 1 regression or missing count, 77 no baseline entry for
+a timing, rate or memory value (ctest reports the test as skipped). With
+DD4SHIP_PERF_UPDATE=1 in the environment the measurement is written to the
+baseline file instead.
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TOP = os.path.dirname(os.path.dirname(HERE))
+sys.path.insert(0, os.path.join(TOP, 'scripts'))
+sys.dont_write_bytecode = True   # keep scripts/ free of __pycache__
+from benchmark import measure  # noqa: E402
+
+SKIP = 77
+EXACT = ('nodes', 'volumes')
+
+
+def buildGeometry(compact):
+  """Child process: build the geometry, print build time and tree sizes as JSON"""
+  import time
+  import ROOT
+  ROOT.gSystem.Load('libDDCore')
+  description = ROOT.dd4hep.Detector.getInstance()
+  start = time.time()
+  description.fromXML(compact)
+  build = time.time() - start
+  mgr = description.manager()
+  print(json.dumps({'build_s': build,
+                    'nodes': int(mgr.CountNodes(mgr.GetTopVolume(), 10000, 0)),
+                    'volumes': int(mgr.GetListOfVolumes().GetEntries())}))
+
+
+def measureGeometry(args):
+  best = None
+  for _ in range(args.repeat):
+    out = subprocess.run([sys.executable, os.path.abspath(__file__), '--build-geometry', args.compact],
+                         stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, universal_newlines=True)
+    if out.returncode != 0:
+      raise RuntimeError('geometry build of %s failed (exit %d)' % (args.compact, out.returncode))
+    result = json.loads(out.stdout.strip().splitlines()[-1])
+    if best is None or result['build_s'] < best['build_s']:
+      best = result
+  if args.counts:
+    best = {name: best[name] for name in EXACT}
+  return os.path.basename(args.compact), best
+
+
+def measureSimulation(args):
+  def command(events):
+    return ['ddsim', '--compactFile', *args.compactFile, '--runType=batch', '-G', '-N=%d' % events,
+            '--steeringFile', args.steeringFile, '--outputFile=perf_%s.root' % args.particle,
+            '--random.seed', str(args.seed), '--gun.particle', args.particle,
+            '--gun.energy', '%g*GeV' % args.energy, '--gun.position', '0.0 0.0 -110.0*cm',
+            '--gun.direction', '0.0 0.0 1.0']
+  label = '%s_%gGeV' % (args.particle, args.energy)
+  one = measure(label + ' N=1', command(1))
+  many = measure(label + ' N=%d' % args.numberOfEvents, command(args.numberOfEvents))
+  if one['status'] != 0 or many['status'] != 0:
+    raise RuntimeError('ddsim failed for %s' % label)
+  perEvent = (many['wall_s'] - one['wall_s']) / max(1, args.numberOfEvents - 1)
+  return label, {'events_per_s': 1. / perEvent if perEvent > 0 else 0., 'maxrss_MB': many['maxrss_MB']}
+
+
+def compare(section, key, measured, baseline):
+  """Return the list of regressions and missing counts; raise KeyError if another value has no baseline entry"""
+  tol = baseline.get('tolerances', {})
+  ref = baseline.get(section, {}).get(key) or {}
+  failures = [name for name in EXACT if name in measured and ref.get(name) is None]
+  for name in failures:
+    print('%-12s %-28s %-14s measured %12d  no baseline   MISSING' % (section, key, name, measured[name]))
+  if failures:
+    return failures
+  if any(ref.get(k) is None for k in measured):
+    raise KeyError(key)
+  for name, value in sorted(measured.items()):
+    expected = ref[name]
+    if name in EXACT:
+      ok = value == expected
+    elif name == 'events_per_s':
+      ok = value >= expected * (1. - tol.get('rate', 0.3))
+    elif name == 'maxrss_MB':
+      ok = value <= expected * (1. + tol.get('rss', 0.2))
+    else:  # times
+      ok = value <= expected * (1. + tol.get('time', 0.3)) + tol.get('time_slack_s', 0.5)
+    print('%-12s %-28s %-14s measured %12.4g  baseline %12.4g  %s' %
+          (section, key, name, value, expected, 'ok' if ok else 'REGRESSION'))
+    if not ok:
+      failures.append(name)
+  return failures
+
+
+def main():
+  if len(sys.argv) == 3 and sys.argv[1] == '--build-geometry':
+    buildGeometry(sys.argv[2])
+    return 0
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('check', choices=('geometry', 'simulation'))
+  parser.add_argument('compact', nargs='?', help='compact file of the geometry check')
+  parser.add_argument('--baseline', default=os.path.join(HERE, 'baseline.json'))
+  parser.add_argument('--repeat', type=int, default=3, help='geometry builds, the fastest counts')
+  parser.add_argument('--counts', action='store_true', help='geometry: check the node and volume counts only')
+  parser.add_argument('--compactFile', nargs='+', default=[os.path.join(TOP, 'SHiPCalo.xml')])
+  parser.add_argument('--steeringFile', default=os.path.join(TOP, 'steering.py'))
+  parser.add_argument('--particle', default='e-')
+  parser.add_argument('--energy', type=float, default=10., help='gun energy in GeV')
+  parser.add_argument('-N', '--numberOfEvents', type=int, default=20)
+  parser.add_argument('--seed', type=int, default=42)
+  args = parser.parse_args()
+
+  if args.check == 'geometry':
+    if not args.compact:
+      parser.error('geometry needs a compact file')
+    if args.counts:
+      args.repeat = 1
+    key, measured = measureGeometry(args)
+  else:
+    key, measured = measureSimulation(args)
+
+  with open(args.baseline) as f:
+    baseline = json.load(f)
+  if os.environ.get('DD4SHIP_PERF_UPDATE', '0') == '1':
+    baseline.setdefault(args.check, {}).setdefault(key, {}).update(measured)
+    with open(args.baseline, 'w') as f:
+      json.dump(baseline, f, indent=2, sort_keys=True)
+      f.write('\n')
+    print('%s %s: baseline updated %s' % (args.check, key, measured))
+    return 0
+  try:
+    failures = compare(args.check, key, measured, baseline)
+  except KeyError:
+    print('%s %s: no baseline, measured %s (record with DD4SHIP_PERF_UPDATE=1)' % (args.check, key, measured))
+    return SKIP
+  return 1 if failures else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Catastrophic muon interactions in the fast muon envelopes, fast versus full simulation.
+
+    fastMuonCatastrophic.py --energy 50 -N 200
+
+Runs ddsim twice with the same muon gun through SHiPCalo.xml, with and
+without the fast muon transport (DD4SHIP_FASTMUONS), and the stepping action
+DD4SHiPMuonCatastrophicCount counting the muBrems and muPairProd interactions
+above CatastrophicFraction of the muon energy in the envelopes; in the fast
+run it adds the interactions forced by the model. The two rates per event
+must agree within --sigma standard deviations of their Poisson errors.
+Exit codes: 0 pass, 1 rates differ, 77 no interaction counted (ctest
+reports the test as skipped).
+"""
+import argparse
+import math
+import os
+import re
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TOP = os.path.dirname(os.path.dirname(HERE))
+SKIP = 77
+COUNTS = re.compile(r'Catastrophic muon interactions: full (\d+) forced (\d+) events (\d+)')
+
+
+def count(args, fast):
+  command = ['ddsim', '--compactFile', args.compactFile, '--runType=batch', '-G', '-N=%d' % args.numberOfEvents,
+             '--steeringFile', args.steeringFile, '--outputFile=catastrophic_%s.root' % ('fast' if fast else 'full'),
+             '--random.seed', str(args.seed), '--gun.particle', args.particle,
+             '--gun.energy', '%g*GeV' % args.energy, '--gun.position', '0.0 0.0 -110.0*cm',
+             '--gun.direction', '0.0 0.0 1.0', '--part.userParticleHandler=',
+             '--action.step', 'DD4SHiPMuonCatastrophicCount/MuonCatastrophicCount']
+  env = dict(os.environ, DD4SHIP_FASTMUONS='1' if fast else '0')
+  out = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True, env=env)
+  match = COUNTS.search(out.stdout)
+  if out.returncode != 0 or not match:
+    sys.stdout.write(out.stdout[-4000:])
+    raise RuntimeError('ddsim failed (exit %d) for the %s run' % (out.returncode, 'fast' if fast else 'full'))
+  full, forced, events = (int(x) for x in match.groups())
+  return full + forced, forced, events
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+  parser.add_argument('--compactFile', default=os.path.join(TOP, 'SHiPCalo.xml'))
+  parser.add_argument('--steeringFile', default=os.path.join(TOP, 'steering.py'))
+  parser.add_argument('--particle', default='mu-')
+  parser.add_argument('--energy', type=float, default=50., help='gun energy in GeV')
+  parser.add_argument('-N', '--numberOfEvents', type=int, default=200)
+  parser.add_argument('--seed', type=int, default=42)
+  parser.add_argument('--sigma', type=float, default=3., help='allowed difference in standard deviations')
+  args = parser.parse_args()
+
+  nFull, _, evFull = count(args, False)
+  nFast, forced, evFast = count(args, True)
+  if nFull == 0 or nFast == 0:
+    print('no catastrophic interaction counted (full %d, fast %d): increase -N' % (nFull, nFast))
+    return SKIP
+  rFull, rFast = nFull / evFull, nFast / evFast
+  error = math.sqrt(nFull / evFull**2 + nFast / evFast**2)
+  pull = (rFast - rFull) / error
+  ok = abs(pull) <= args.sigma
+  print('catastrophic interactions per event: full %.4f (%d), fast %.4f (%d, %d forced)  pull %+.2f  %s' %
+        (rFull, nFull, rFast, nFast, forced, pull, 'ok' if ok else 'MISMATCH'))
+  return 0 if ok else 1
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,69 @@
+//==========================================================================
+//  AIDA Detector description implementation
+//--------------------------------------------------------------------------
+// Copyright (C) Organisation europeenne pour la Recherche nucleaire (CERN)
+// All rights reserved.
+//
+// For the licensing terms see $DD4hepINSTALL/LICENSE.
+// For the list of contributors see $DD4hepINSTALL/doc/CREDITS.
+//
+// Author     : M.Climescu
+// Date       : 19.10.2026
+//==========================================================================
+//
+// Checks of dd4ship::ShowerAxisFit on centroids exactly on a line: many
+// layers, two layers per view (the degenerate case of a vanishing residual
+// scale) and one outlying layer that the Huber weights must suppress.
+//
+//==========================================================================
+#include <DD4SHiP/ShowerAxisFit.h>
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+  int failures = 0;
+
+  void check(bool ok, const char* test, const char* what, double value)  {
+    std::printf("%-14s %-28s %12.6g  %s\n", test, what, value, ok ? "ok" : "FAILED");
+    if ( !ok ) ++failures;
+  }
+
+  /// One event with nlayer layers per view on x = x0 + tx*z, y = y0 + ty*z; layer 'outlier' shifted in x
+  dd4ship::ShowerAxis fitLine(int nlayer, double tx, double x0, double ty, double y0, int outlier = -1,
+                              double shift = 0e0, const dd4ship::ShowerAxisConfig& cfg = dd4ship::ShowerAxisConfig())  {
+    dd4ship::ShowerAxisFit fit(2*nlayer, cfg);
+    for( int l = 0; l < nlayer; ++l )  {
+      const double z = 10e0*l;
+      fit.addHit(2*l,   dd4ship::AXIS_X, x0 + tx*z + (l == outlier ? shift : 0e0), z, 5e0);
+      fit.addHit(2*l+1, dd4ship::AXIS_Y, y0 + ty*(z + 5e0), z + 5e0, 5e0);
+    }
+    fit.endEvent();
+    fit.flush();
+    return fit.results().at(0);
+  }
+
+  void checkLine(const char* test, const dd4ship::ShowerAxis& r, double tx, double x0, double ty, double y0,
+                 double tol)  {
+    check(r.status == 0,                      test, "status",     r.status);
+    check(std::abs(r.tx - tx) < tol,          test, "tx",         r.tx);
+    check(std::abs(r.x0 - x0) < 10e0*tol,     test, "x0 [mm]",    r.x0);
+    check(std::abs(r.ty - ty) < tol,          test, "ty",         r.ty);
+    check(std::abs(r.y0 - y0) < 10e0*tol,     test, "y0 [mm]",    r.y0);
+    check(r.sigma_tx > 0 && r.sigma_ty > 0,   test, "sigma_tx",   r.sigma_tx);
+    check(r.sigma_x0 > 0 && r.sigma_y0 > 0,   test, "sigma_x0",   r.sigma_x0);
+  }
+}
+
+int main()  {
+  checkLine("exact fit",   fitLine(8, 0.02, 1.5, -0.01, -3.0), 0.02, 1.5, -0.01, -3.0, 1e-5);
+  checkLine("two layers",  fitLine(2, 0.05, -2.0, 0.03, 4.0), 0.05, -2.0, 0.03, 4.0, 1e-5);
+  // the reweighted fit is pulled less by the outlier than plain least squares
+  dd4ship::ShowerAxisConfig lsq;
+  lsq.iterations = 0;
+  const dd4ship::ShowerAxis r = fitLine(8, 0.02, 1.5, -0.01, -3.0, 3, 100e0);
+  const dd4ship::ShowerAxis l = fitLine(8, 0.02, 1.5, -0.01, -3.0, 3, 100e0, lsq);
+  check(std::abs(r.x0 - 1.5) < 0.8*std::abs(l.x0 - 1.5), "outlier", "x0 [mm]", r.x0);
+  check(std::abs(r.ty + 0.01) < 1e-5,                    "outlier", "ty", r.ty);
+  return failures ? 1 : 0;
+}